@@ -1,7 +1,7 @@
 /*
  * Author: Evan Jones III
  * Initial Commit: 10/29/2025
- * Last Commit: 11/4/2025
+ * Last Commit: 10/19/2026
  *
  * A simple library for using the ADC on the MSP430G2553
  *
@@ -13,10 +13,11 @@
 
 #include <msp430g2553.h>
 #include "adc.h"
+#include "power.h"
 #include <stdint.h>
 
 // ADC single sample/read functions
-int adc_single_init(int channel){
+int adc_single_init(uint8_t channel){
     // Reset ADC to prevent misconfiguration
     ADC10CTL0 = 0x0000;         // Must be done before other registers as ENC being set to 1 would prevent configuration
     ADC10CTL1 = 0x0000;
@@ -62,7 +63,9 @@ int adc_single_init(int channel){
             ADC10AE0 = 0b10000000;
             break;
         case 10:
-            ADC10CTL1 = INCH_10 + ADC10DF;
+            ADC10CTL0 |= ADC10SHT_3;                // Temp sensor needs a 30 us sample time,
+            ADC10CTL1 = INCH_10 + ADC10DF + ADC10DIV_3; // 64 cycles of ADC10OSC/4
+            break;
         default:
             return -1;
     }
@@ -70,9 +73,13 @@ int adc_single_init(int channel){
 }
 
 int adc_single_read(void){
+    __disable_interrupt();              // Nothing can wake the CPU before it sleeps
     ADC10CTL0 |= ENC + ADC10SC;
-    __enable_interrupt();
-    LPM0;
+    power_mark(PWR_ADC, PWR_ADC_REF);       // REFBURST keeps the reference on only for the conversion
+    power_lpm_enter(PWR_LPM0);
+    __bis_SR_register(LPM0_bits + GIE); // Sleep with interrupts on, the ISR can't run before LPM0
+    power_lpm_exit();
+    power_mark(PWR_ADC, PWR_OFF);
     ADC10CTL0 ^= ENC;
     __disable_interrupt();
     return ADC10MEM;
@@ -81,7 +88,7 @@ int adc_single_read(void){
 
 
 // TODO: ADC Sequence Functions
-int adc_seq_init(int channels){
+int adc_seq_init(uint8_t channels){
     // Reset ADC to prevent misconfiguration
     ADC10CTL0 = 0x0000;         // Must be done before other registers as ENC being set to 1 would prevent configuration
     ADC10CTL1 = 0x0000;
@@ -90,8 +97,8 @@ int adc_seq_init(int channels){
     ADC10DTC1 = 0x00;
     ADC10SA = 0x0000;
 
-    // Enable the ADC and interrupt flag
-    ADC10CTL0 = SREF_1 + ADC10SHT_2 + REF2_5V + REFBURST + REFON + ADC10ON + ADC10IE;
+    // Enable the ADC and interrupt flag, MSC so a block converts without an ADC10SC per sample
+    ADC10CTL0 = SREF_1 + ADC10SHT_2 + REF2_5V + REFBURST + MSC + REFON + ADC10ON + ADC10IE;
 
     // Enable channels iteratively
     uint8_t i;
@@ -109,9 +116,14 @@ int adc_seq_read(unsigned int addr, uint8_t num_samps){
     ADC10DTC0 = 0x00;
     ADC10DTC1 = num_samps;
     ADC10SA = addr;
+    ADC10CTL0 &= ~ADC10IFG;             // Drop the flag from a conversion that finished after the last block
+    __disable_interrupt();              // Nothing can wake the CPU before it sleeps
     ADC10CTL0 |= ENC + ADC10SC;
-    __enable_interrupt();
-    LPM0;
+    power_mark(PWR_ADC, PWR_ADC_REF);       // REFBURST keeps the reference on only for the conversion
+    power_lpm_enter(PWR_LPM0);
+    __bis_SR_register(LPM0_bits + GIE); // Sleep with interrupts on, the ISR can't run before LPM0
+    power_lpm_exit();
+    power_mark(PWR_ADC, PWR_OFF);
     ADC10CTL0 ^= ENC;
     __disable_interrupt();
     return 0;
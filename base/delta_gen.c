@@ -0,0 +1,233 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Making compressed binary deltas between firmware images at the base station. Each segment of the
+ * new image is encoded greedily with the longest of: a run of one byte, a match in the old image
+ * (only at or after this segment, see delta.h), or a match earlier in this segment of the new image.
+ * Matches in the old image are found through hash chains on 3 byte prefixes.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../crc.h"
+#include "../flash.h"
+#include "../delta.h"
+#include "delta_gen.h"
+
+#define HASH_BITS       14
+#define MIN_MATCH       4
+#define MIN_FILL        3
+
+typedef struct{
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+} Out;
+
+static int put(Out *o, uint8_t b){
+    if(o->len >= o->cap){
+        return -1;
+    }
+    o->buf[o->len++] = b;
+    return 0;
+}
+
+static int put_op(Out *o, uint8_t type, uint16_t len){
+    if(len > 63){
+        return put(o, type | 0x3F) | put(o, len - 64);
+    }
+    return put(o, type | (len - 1));
+}
+
+static int put_u16(Out *o, uint16_t v){
+    return put(o, v & 0xFF) | put(o, v >> 8);
+}
+
+static uint32_t hash3(const uint8_t *p){
+    return ((p[0] << 16 | p[1] << 8 | p[2]) * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static int flush_literal(Out *o, const uint8_t *lit, uint16_t *n){
+    uint16_t i;
+    if(*n == 0){
+        return 0;
+    }
+    if(put_op(o, DELTA_LITERAL, *n)){
+        return -1;
+    }
+    for(i=0; i<*n; i++){
+        if(put(o, lit[i])){
+            return -1;
+        }
+    }
+    *n = 0;
+    return 0;
+}
+
+/*
+ * Writes a delta from old_img to new_img (both OTA_IMAGE_SIZE bytes) into out. Returns the delta
+ * length or -1 if it doesn't fit in cap bytes.
+ */
+long delta_make(const uint8_t *old_img, const uint8_t *new_img, uint8_t *out, size_t cap){
+    Out o = {out, cap, 0};
+    int32_t *head = malloc(sizeof(int32_t) << HASH_BITS);
+    int32_t *prev = malloc(sizeof(int32_t) * OTA_IMAGE_SIZE);
+    uint8_t lit[DELTA_MAX_LEN];
+    uint16_t nlit = 0;
+    long i;
+    int seg, err = 0;
+
+    if(head == NULL || prev == NULL){
+        free(head);
+        free(prev);
+        return -1;
+    }
+    // Chains run from the end of the old image back so each walk sees the latest positions first
+    for(i=0; i<(1 << HASH_BITS); i++){
+        head[i] = -1;
+    }
+    for(i=OTA_IMAGE_SIZE-3; i>=0; i--){
+        uint32_t h = hash3(&old_img[i]);
+        prev[i] = head[h];
+        head[h] = i;
+    }
+
+    err |= put_u16(&o, DELTA_MAGIC);
+    err |= put(&o, DELTA_VERSION);
+    err |= put(&o, OTA_IMAGE_SEGS);
+    err |= put_u16(&o, crc16(old_img, OTA_IMAGE_SIZE));
+    err |= put_u16(&o, crc16(new_img, OTA_IMAGE_SIZE));
+
+    for(seg=0; seg<OTA_IMAGE_SEGS && !err; seg++){
+        const uint8_t *s = &new_img[seg*FLASH_SEG_SIZE];
+        uint16_t pos = 0;
+        while(pos < FLASH_SEG_SIZE && !err){
+            uint16_t max = FLASH_SEG_SIZE - pos, best = 0, fill = 1, len;
+            uint8_t type = DELTA_LITERAL;
+            uint16_t src = 0;
+            if(max > DELTA_MAX_LEN){
+                max = DELTA_MAX_LEN;
+            }
+
+            while(fill < max && s[pos+fill] == s[pos]){
+                fill++;
+            }
+            if(fill >= MIN_FILL){
+                best = fill;
+                type = DELTA_FILL;
+            }
+
+            if(max >= 3){                       // Old image, only from this segment on
+                int32_t c;
+                int walk = 0;
+                for(c=head[hash3(&s[pos])]; c>=0 && walk<256; c=prev[c], walk++){
+                    if(c < seg*FLASH_SEG_SIZE){
+                        continue;
+                    }
+                    for(len=0; len<max && (uint32_t)(c+len)<OTA_IMAGE_SIZE && old_img[c+len]==s[pos+len]; len++);
+                    if(len >= MIN_MATCH && len > best + (type == DELTA_FILL)){
+                        best = len;
+                        type = DELTA_COPY_OLD;
+                        src = c;
+                        if(len == max){
+                            break;
+                        }
+                    }
+                }
+            }
+
+            for(i=0; i<pos; i++){               // New segment so far, overlapping copies are fine
+                for(len=0; len<max && s[i+len]==s[pos+len]; len++);
+                if(len >= MIN_MATCH && len > best + (type == DELTA_FILL)){
+                    best = len;
+                    type = DELTA_COPY_NEW;
+                    src = i;
+                }
+            }
+
+            if(best == 0 || type == DELTA_LITERAL){
+                lit[nlit++] = s[pos++];
+                if(nlit == DELTA_MAX_LEN){
+                    err |= flush_literal(&o, lit, &nlit);
+                }
+                continue;
+            }
+            err |= flush_literal(&o, lit, &nlit);
+            err |= put_op(&o, type, best);
+            if(type == DELTA_FILL){
+                err |= put(&o, s[pos]);
+            }
+            else{
+                err |= put_u16(&o, src);
+            }
+            pos += best;
+        }
+        err |= flush_literal(&o, lit, &nlit);  // Ops never run across a segment
+    }
+
+    free(head);
+    free(prev);
+    return err ? -1 : (long)o.len;
+}
+
+/*
+ * Loads a firmware image into img (OTA_IMAGE_SIZE bytes), and the bootloader section it was linked
+ * with into boot (OTA_BOOT_SIZE bytes). Either a raw image in the layout from ota.h, which has no
+ * bootloader and leaves boot erased, or a TI-TXT file as written by hex430 --ti_txt, which is mapped
+ * into that layout. Returns -1 if the file can't be read or has bytes outside the image and
+ * bootloader.
+ */
+int image_load(const char *path, uint8_t *img, uint8_t *boot){
+    FILE *f = fopen(path, "rb");
+    int c;
+    if(f == NULL){
+        return -1;
+    }
+    memset(img, 0xFF, OTA_IMAGE_SIZE);
+    memset(boot, 0xFF, OTA_BOOT_SIZE);
+    c = fgetc(f);
+    if(c != '@'){                               // Raw
+        ungetc(c, f);
+        size_t n = fread(img, 1, OTA_IMAGE_SIZE, f);
+        int extra = fgetc(f);
+        fclose(f);
+        return (n == OTA_IMAGE_SIZE && extra == EOF) ? 0 : -1;
+    }
+
+    unsigned addr = 0, byte;
+    char tok[16];
+    ungetc(c, f);
+    while(fscanf(f, "%15s", tok) == 1){
+        if(tok[0] == 'q'){
+            break;
+        }
+        if(tok[0] == '@'){
+            addr = strtoul(&tok[1], NULL, 16);
+            continue;
+        }
+        byte = strtoul(tok, NULL, 16);
+        if(addr >= OTA_APP_BASE && addr < OTA_APP_BASE + OTA_APP_SEGS*FLASH_SEG_SIZE){
+            img[addr - OTA_APP_BASE] = byte;
+        }
+        else if(addr >= OTA_VECT_BASE && addr <= 0xFFFF){
+            img[OTA_APP_SEGS*FLASH_SEG_SIZE + addr - OTA_VECT_BASE] = byte;
+        }
+        else if(addr >= OTA_BOOT_BASE && addr < OTA_BOOT_BASE + OTA_BOOT_SIZE){
+            boot[addr - OTA_BOOT_BASE] = byte;  // Not part of the image, nodes never rewrite it
+        }
+        else{
+            fclose(f);
+            return -1;
+        }
+        addr++;
+    }
+    fclose(f);
+    return 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Making compressed binary deltas between firmware images at the base station (see delta.h for
+ * the format and ota.h for the image layout), and loading images built by CCS.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../ota.h"
+
+#ifndef DELTA_GEN_H_
+#define DELTA_GEN_H_
+
+long delta_make(const uint8_t *old_img, const uint8_t *new_img, uint8_t *out, size_t cap);
+int image_load(const char *path, uint8_t *img, uint8_t *boot);
+
+#endif /* DELTA_GEN_H_ */
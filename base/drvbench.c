@@ -0,0 +1,434 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Micro-benchmarks for the node's drivers on the virtual G2553 (sim/vm.h) at 16 MHz, checked against
+ * a baseline so a change that makes a driver slower shows up before it shows up as battery life.
+ * Covers A0 and B0 SPI transmit and receive at every length up to MAX_BUF_SIZE, adc_single_read(),
+ * adc_seq_read() blocks of 1 to 128 samples, and the temperature and snow depth conversions.
+ *
+ * Measured per case
+ *  cycles      MCLK cycles with the CPU on, as the model charges them: register accesses, interrupt
+ *              entry and exit, delays, and the code in between at sim/blocks.awk's estimate
+ *  isrs        interrupts taken
+ *  stack       bytes of stack the case used from its call down, found by painting the node's stack.
+ *              Host code, ISRs included.
+ *  flash       bytes of host code in the case's functions and ISRs, from this program's symbols
+ *
+ * Stack and flash come from the host build, so they're only compared against a baseline made by the
+ * same compiler. Cycles and interrupts are the model's and are always compared. A case fails when
+ * any of them grew by more than the tolerance.
+ *
+ * usage: drvbench [-t tolerance %] [-w] baseline
+ *          -w writes the baseline instead of checking against it
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <alloca.h>
+#include <elf.h>
+#include <msp430g2553.h>
+#include "sim/vm.h"
+#include "../usci.h"
+#include "../adc.h"
+#include "../sensors.h"
+#include "../power.h"
+
+#define DRV_MAX_RESULTS     256
+#define DRV_MAX_CODE        4
+#define DRV_PAINT           0xA5
+#define DRV_TEMP_C          (-5.0)      // What the sensors see
+#define DRV_DEPTH_MM        600.0
+#if defined(__x86_64__)
+#define DRV_ARCH            " x86_64"
+#elif defined(__aarch64__)
+#define DRV_ARCH            " aarch64"
+#else
+#define DRV_ARCH            ""
+#endif
+#define DRV_LIMIT_S         60          // Virtual time for every case together, a driver past it is stuck
+
+typedef struct DRV_CaseStruct{
+    const char *name;                   // printf format, given the length if there is one
+    int (*setup)(void);                 // Not measured
+    int (*run)(void);
+    uint8_t first, last;                // Lengths to run at, 0 for none
+    uint8_t doubling;                   // Lengths double rather than step by 1
+    const char *code[DRV_MAX_CODE];     // Functions that count towards flash
+} DRV_Case;
+
+typedef struct DRV_ResultStruct{
+    const DRV_Case *c;
+    char name[32];
+    uint64_t cycles;
+    uint64_t isrs;
+    uint64_t stack;
+    uint64_t flash;
+} DRV_Result;
+
+static DRV_Result results[DRV_MAX_RESULTS];
+static int nresults;
+static int failed;                      // A driver returned an error
+static char drv_buf[MAX_BUF_SIZE];
+static uint8_t drv_len;
+
+/*
+ * Cases, run on the node
+ */
+static int drv_a0_init(void){ return A0_spi_init(); }
+static int drv_b0_init(void){ return B0_spi_init(); }
+static int drv_a0_tx(void){ return A0_spi_transmit(0x20, drv_buf, drv_len); }
+static int drv_a0_rx(void){ return A0_spi_receive(0x61, drv_buf, drv_len); }
+static int drv_b0_tx(void){ return B0_spi_transmit(0x20, drv_buf, drv_len); }
+static int drv_b0_rx(void){ return B0_spi_receive(0x61, drv_buf, drv_len); }
+static int drv_single_init(void){ return adc_single_init(4); }
+static int drv_single(void){ adc_single_read(); return 0; }
+static int drv_seq_init(void){ return adc_seq_init(BIT0 | BIT1 | BIT2 | BIT3); }
+static int drv_seq(void){ return adc_seq_read(VM_RAM, drv_len); }
+static int drv_none(void){ return 0; }
+static int drv_temp(void){ temperature(); return 0; }
+static int drv_depth(void){ return (snow_depth() < 0) ? -1 : 0; }
+
+static const DRV_Case cases[] = {
+    {"A0_spi_transmit/%u", drv_a0_init, drv_a0_tx, 1, MAX_BUF_SIZE, 0, {"A0_spi_transmit", "USCIAB0TX_ISR"}},
+    {"A0_spi_receive/%u", drv_a0_init, drv_a0_rx, 1, MAX_BUF_SIZE, 0, {"A0_spi_receive", "USCIAB0RX_ISR"}},
+    {"B0_spi_transmit/%u", drv_b0_init, drv_b0_tx, 1, MAX_BUF_SIZE, 0, {"B0_spi_transmit", "USCIAB0TX_ISR"}},
+    {"B0_spi_receive/%u", drv_b0_init, drv_b0_rx, 1, MAX_BUF_SIZE, 0, {"B0_spi_receive", "USCIAB0RX_ISR"}},
+    {"adc_single_read", drv_single_init, drv_single, 0, 0, 0, {"adc_single_read", "ADC10_ISR"}},
+    {"adc_seq_read/%u", drv_seq_init, drv_seq, 1, 128, 1, {"adc_seq_read", "ADC10_ISR"}},
+    {"temperature", drv_none, drv_temp, 0, 0, 0, {"temperature", "adc_single_init", "adc_single_read", "ADC10_ISR"}},
+    {"snow_depth", snow_depth_init, drv_depth, 0, 0, 0, {"snow_depth", "ping", "TIMER1_A0_ISR", "TIMER1_A1_ISR"}},
+};
+
+#define DRV_CASES   (sizeof(cases) / sizeof(cases[0]))
+
+/*
+ * Runs a case with the node's stack painted below it, and puts the bytes it used in *stack. The
+ * alloca() finds where the stack pointer is, so everything below it is painted and the case's own
+ * call is the first thing to use it. Painted byte by byte through a volatile pointer so it can't
+ * become a call to memset() that would use the stack it's painting.
+ */
+static int __attribute__((noinline)) drv_run(int (*run)(void), uint64_t *stack){
+    char *sp = alloca(1);
+    volatile char *p = vm_stack;
+    int ret;
+    while(p < sp){
+        *p++ = DRV_PAINT;
+    }
+    ret = run();
+    for(p=vm_stack; p < sp && *p == (char)DRV_PAINT; p++);
+    *stack = sp - p;
+    return ret;
+}
+
+static uint64_t drv_cycles(const VM_Time *spent){
+    static const uint8_t mhz[] = {1, 8, 12, 16};
+    uint64_t t = 0;
+    uint8_t i;
+    for(i=0; i<4; i++){
+        t += (vm_node.spent[PWR_ACTIVE_1MHZ + i] - spent[i]) * mhz[i];
+    }
+    return t / (VM_HZ / 1000000);
+}
+
+static void drv_measure(const DRV_Case *c, uint8_t len){
+    DRV_Result *r = &results[nresults++];
+    VM_Time spent[4];
+    uint64_t isrs;
+
+    r->c = c;
+    snprintf(r->name, sizeof(r->name), c->name, len);
+    drv_len = len;
+    if(c->setup() != 0){
+        failed = 1;
+    }
+    power_init();                       // TA0R starts over, so its overflow never lands in a case
+    vm_reseed(vm_node.seed);            // Nor does what ran before change its echoes
+    vm_settle();
+    vm_account();
+    memcpy(spent, &vm_node.spent[PWR_ACTIVE_1MHZ], sizeof(spent));
+    isrs = vm_node.interrupts;
+    if(drv_run(c->run, &r->stack) != 0){
+        failed = 1;
+    }
+    vm_settle();
+    vm_account();
+    r->cycles = drv_cycles(spent);
+    r->isrs = vm_node.interrupts - isrs;
+}
+
+static int drv_main(void){
+    const DRV_Case *c;
+    unsigned len;
+
+    WDTCTL = WDTPW | WDTHOLD;
+    BCSCTL3 = LFXT1S_2;
+    BCSCTL2 = 0x00;
+    power_set_dco(PWR_DCO_MHZ);
+    for(c=cases; c<cases+DRV_CASES; c++){
+        if(c->first == 0){
+            drv_measure(c, 0);
+            continue;
+        }
+        for(len=c->first; len<=c->last && nresults<DRV_MAX_RESULTS; len=c->doubling ? len*2 : len+1){
+            drv_measure(c, len);
+        }
+    }
+    return 0;
+}
+
+static double drv_env(void *ctx, uint8_t node, uint8_t sensor, double seconds){
+    (void)ctx;
+    (void)node;
+    (void)seconds;
+    return (sensor == 0x01) ? DRV_TEMP_C : DRV_DEPTH_MM;    // packet.h PKT_SEN_TEMP or depth
+}
+
+/*
+ * Code sizes from this program's symbol table
+ */
+static uint8_t *image;
+static const Elf64_Sym *syms;
+static size_t nsyms;
+static const char *symnames;
+
+static int drv_load_symbols(void){
+    const Elf64_Ehdr *eh;
+    const Elf64_Shdr *sh;
+    FILE *f;
+    long size;
+    int i;
+
+    if((f = fopen("/proc/self/exe", "rb")) == NULL){
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    rewind(f);
+    if(size < (long)sizeof(Elf64_Ehdr) || (image = malloc(size)) == NULL || fread(image, 1, size, f) != (size_t)size){
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    eh = (const Elf64_Ehdr *)image;
+    if(memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 || eh->e_ident[EI_CLASS] != ELFCLASS64){
+        return -1;
+    }
+    sh = (const Elf64_Shdr *)(image + eh->e_shoff);
+    for(i=0; i<eh->e_shnum; i++){
+        if(sh[i].sh_type == SHT_SYMTAB){
+            syms = (const Elf64_Sym *)(image + sh[i].sh_offset);
+            nsyms = sh[i].sh_size / sizeof(Elf64_Sym);
+            symnames = (const char *)(image + sh[sh[i].sh_link].sh_offset);
+            return 0;
+        }
+    }
+    return -1;                          // Stripped
+}
+
+// 0 for a function that was inlined away
+static uint64_t drv_symbol_size(const char *name){
+    size_t i;
+    for(i=0; i<nsyms; i++){
+        if(ELF64_ST_TYPE(syms[i].st_info) == STT_FUNC && strcmp(symnames + syms[i].st_name, name) == 0){
+            return syms[i].st_size;
+        }
+    }
+    return 0;
+}
+
+static uint64_t drv_flash(const DRV_Case *c){
+    uint64_t total = 0;
+    int i;
+    for(i=0; i<DRV_MAX_CODE && c->code[i] != NULL; i++){
+        total += drv_symbol_size(c->code[i]);
+    }
+    return total;
+}
+
+/*
+ * Baseline
+ */
+static const char *drv_compiler(void){
+#if defined(__clang__)
+    return __VERSION__ DRV_ARCH;        // "Clang x.y.z ..."
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__ DRV_ARCH;
+#else
+    return "unknown" DRV_ARCH;
+#endif
+}
+
+static int drv_write(const char *path){
+    FILE *f = fopen(path, "w");
+    int i;
+    if(f == NULL){
+        return -1;
+    }
+    fprintf(f, "# drvbench baseline, see drvbench.c. Stack and flash are from the host build below.\n");
+    fprintf(f, "# compiler %s\n", drv_compiler());
+    fprintf(f, "# case cycles isrs stack flash\n");
+    for(i=0; i<nresults; i++){
+        fprintf(f, "%s %llu %llu %llu %llu\n", results[i].name, (unsigned long long)results[i].cycles,
+                (unsigned long long)results[i].isrs, (unsigned long long)results[i].stack,
+                (unsigned long long)results[i].flash);
+    }
+    return (fclose(f) != 0) ? -1 : 0;
+}
+
+// 1 if a metric grew past the tolerance, -1 if it shrank past it
+static int drv_compare(const char *case_name, const char *metric, uint64_t now, uint64_t base, double tol){
+    double change = (base > 0) ? ((double)now - base) / base : (now > 0);
+    if(change > tol){
+        printf("REGRESSED %s %s %llu -> %llu (%+.1f%%)\n", case_name, metric, (unsigned long long)base,
+               (unsigned long long)now, change * 100);
+        return 1;
+    }
+    if(change < -tol){
+        printf("improved %s %s %llu -> %llu (%+.1f%%)\n", case_name, metric, (unsigned long long)base,
+               (unsigned long long)now, change * 100);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Returns the number of regressions, or -1 if the baseline can't be read
+ */
+static int drv_check(const char *path, double tol){
+    char line[256], name[64], compiler[256] = "";
+    unsigned long long cycles, isrs, stack, flash;
+    int i, seen[DRV_MAX_RESULTS] = {0}, worse = 0, better = 0, host, r;
+    FILE *f = fopen(path, "r");
+
+    if(f == NULL){
+        return -1;
+    }
+    while(fgets(line, sizeof(line), f) != NULL){
+        if(strncmp(line, "# compiler ", 11) == 0){
+            snprintf(compiler, sizeof(compiler), "%s", line + 11);
+            compiler[strcspn(compiler, "\n")] = '\0';
+        }
+    }
+    host = strcmp(compiler, drv_compiler()) == 0;
+    if(!host){
+        printf("baseline is from \"%s\", not \"%s\", so stack and flash aren't checked\n", compiler, drv_compiler());
+    }
+    rewind(f);
+    while(fgets(line, sizeof(line), f) != NULL){
+        if(line[0] == '#' || sscanf(line, "%63s %llu %llu %llu %llu", name, &cycles, &isrs, &stack, &flash) != 5){
+            continue;
+        }
+        for(i=0; i<nresults && strcmp(results[i].name, name) != 0; i++){
+        }
+        if(i == nresults){
+            printf("%s is in the baseline but wasn't run\n", name);
+            continue;
+        }
+        seen[i] = 1;
+        r = drv_compare(name, "cycles", results[i].cycles, cycles, tol);
+        worse += r > 0;
+        better += r < 0;
+        r = drv_compare(name, "isrs", results[i].isrs, isrs, tol);
+        worse += r > 0;
+        better += r < 0;
+        if(host){
+            r = drv_compare(name, "stack", results[i].stack, stack, tol);
+            worse += r > 0;
+            better += r < 0;
+            r = drv_compare(name, "flash", results[i].flash, flash, tol);
+            worse += r > 0;
+            better += r < 0;
+        }
+    }
+    fclose(f);
+    for(i=0; i<nresults; i++){
+        if(!seen[i]){
+            printf("%s isn't in the baseline\n", results[i].name);
+        }
+    }
+    if(better > 0 && worse == 0){
+        printf("%d improvements, run with -w to keep them\n", better);
+    }
+    return worse;
+}
+
+int main(int argc, char **argv){
+    double tol = 5;
+    int write = 0, opt, i, worse;
+
+    while((opt = getopt(argc, argv, "t:w")) != -1){
+        switch(opt){
+            case 't': tol = atof(optarg); break;
+            case 'w': write = 1; break;
+            default:
+                fprintf(stderr, "usage: %s [-t tolerance %%] [-w] baseline\n", argv[0]);
+                return 2;
+        }
+    }
+    if(argc - optind != 1){
+        fprintf(stderr, "usage: %s [-t tolerance %%] [-w] baseline\n", argv[0]);
+        return 2;
+    }
+
+    vm_node.id = 1;
+    vm_node.seed = 1;
+    vm_node.env = drv_env;
+    vm_node.until = (VM_Time)DRV_LIMIT_S * VM_HZ;
+    vm_node.heard = VM_NEVER;
+    vm_node.entry = drv_main;
+    if(vm_start() != 0){
+        fprintf(stderr, "can't start the node\n");
+        return 1;
+    }
+    vm_resume();
+    if(vm_node.status != VM_HALTED){
+        fprintf(stderr, "%s was still running after %d s\n", results[nresults - 1].name, DRV_LIMIT_S);
+        return 1;
+    }
+    if(strcmp(vm_node.halt, "main returned") != 0){
+        fprintf(stderr, "%s stopped the node: %s\n", results[nresults - 1].name, vm_node.halt);
+        return 1;
+    }
+    if(failed){
+        fprintf(stderr, "a driver returned an error\n");
+        return 1;
+    }
+    if(drv_load_symbols() != 0){
+        fprintf(stderr, "can't read this program's symbols, flash won't be measured\n");
+    }
+    for(i=0; i<nresults; i++){
+        results[i].flash = drv_flash(results[i].c);
+    }
+
+    printf("%-24s %10s %6s %7s %7s\n", "case", "cycles", "isrs", "stack", "flash");
+    for(i=0; i<nresults; i++){
+        printf("%-24s %10llu %6llu %7llu %7llu\n", results[i].name, (unsigned long long)results[i].cycles,
+               (unsigned long long)results[i].isrs, (unsigned long long)results[i].stack,
+               (unsigned long long)results[i].flash);
+    }
+    if(write){
+        if(drv_write(argv[optind]) != 0){
+            fprintf(stderr, "can't write %s\n", argv[optind]);
+            return 1;
+        }
+        return 0;
+    }
+    worse = drv_check(argv[optind], tol / 100);
+    if(worse < 0){
+        fprintf(stderr, "can't read %s, make one with -w\n", argv[optind]);
+        return 1;
+    }
+    if(worse > 0){
+        printf("%d regressions beyond %.1f%%\n", worse, tol);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Battery life projection at the base station from the energy summaries piggybacked on node
+ * reports (see power.h).
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "energy.h"
+
+// Names for the states in PWR_State, in the same order
+static const char *en_state_names[] = {
+    "active 1MHz",
+    "active 8MHz",
+    "active 12MHz",
+    "active 16MHz",
+    "LPM0",
+    "LPM3",
+    "ADC ref",
+    "radio TX",
+    "radio RX",
+    "radio standby",
+    "radio power down",
+    "board floor",
+    "ranger idle",
+    "ranger ping"
+};
+
+void energy_init(EN_Table *table, double capacity_mah){
+    memset(table, 0, sizeof(*table));
+    table->capacity_mah = capacity_mah;
+}
+
+/*
+ * Records an energy summary received from a node at time (seconds). Returns -1 if the summary is
+ * older than the last one from the node, or shows the counter going backwards (node reset), in
+ * which case the history for the node is restarted.
+ */
+int energy_update(EN_Table *table, uint8_t node, double time, uint32_t uah, uint8_t top_state, uint8_t top_share){
+    EN_Node *n = &table->nodes[node];
+    n->top_state = top_state;
+    n->top_share = top_share;
+    if(!n->seen || time <= n->last_time || uah < n->last_uah){
+        int err = n->seen ? -1 : 0;
+        n->seen = 1;
+        n->last_time = time;
+        n->last_uah = uah;
+        n->rate_uah_per_h = 0;
+        return err;
+    }
+
+    double rate = (uah - n->last_uah) / ((time - n->last_time) / 3600.0);
+    if(n->rate_uah_per_h == 0){
+        n->rate_uah_per_h = rate;
+    }
+    else{
+        n->rate_uah_per_h += EN_RATE_ALPHA * (rate - n->rate_uah_per_h);
+    }
+    n->last_time = time;
+    n->last_uah = uah;
+    return 0;
+}
+
+/*
+ * Projected hours of battery left for a node, or -1 if there isn't enough history yet. The charge
+ * reported by a node counts from its last reset, so this assumes the battery was fresh at reset.
+ */
+double energy_life_hours(const EN_Table *table, uint8_t node){
+    const EN_Node *n = &table->nodes[node];
+    if(!n->seen || n->rate_uah_per_h <= 0){
+        return -1;
+    }
+    double left = table->capacity_mah * 1000.0 - n->last_uah;
+    if(left < 0){
+        left = 0;
+    }
+    return left / n->rate_uah_per_h;
+}
+
+/*
+ * Finds the node with the least battery life left. Returns how many nodes have a projection, and
+ * if any do sets *node and *hours to the shortest.
+ */
+int energy_shortest(const EN_Table *table, uint8_t *node, double *hours){
+    double h;
+    int i, n = 0;
+    for(i=0; i<EN_MAX_NODES; i++){
+        h = energy_life_hours(table, i);
+        if(h < 0){
+            continue;
+        }
+        if(n == 0 || h < *hours){
+            *node = i;
+            *hours = h;
+        }
+        n++;
+    }
+    return n;
+}
+
+const char *energy_state_name(uint8_t state){
+    if(state >= sizeof(en_state_names)/sizeof(en_state_names[0])){
+        return "unknown";
+    }
+    return en_state_names[state];
+}
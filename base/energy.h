@@ -0,0 +1,43 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Battery life projection at the base station from the energy summaries piggybacked on node
+ * reports (see power.h). The discharge rate is a moving average of the charge drawn between
+ * summaries, so a node that starts drawing more (ex: stuck in RX) shows up within a few reports.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+
+#ifndef ENERGY_H_
+#define ENERGY_H_
+
+#define EN_MAX_NODES        256
+#define EN_CAPACITY_MAH     2500.0      // Default battery, 2x AA lithium
+#define EN_RATE_ALPHA       0.25        // Weight of the newest summary in the moving average
+
+typedef struct EN_NodeStruct{
+    uint8_t seen;                       // A summary has been received
+    double last_time;                   // Seconds, time of the last summary
+    uint32_t last_uah;                  // Charge reported by the last summary
+    double rate_uah_per_h;              // Moving average discharge rate, 0 until two summaries arrive
+    uint8_t top_state;                  // Most expensive power state in the last summary
+    uint8_t top_share;                  // and its share of the charge in percent
+} EN_Node;
+
+typedef struct EN_TableStruct{
+    double capacity_mah;
+    EN_Node nodes[EN_MAX_NODES];
+} EN_Table;
+
+void energy_init(EN_Table *table, double capacity_mah);
+int energy_update(EN_Table *table, uint8_t node, double time, uint32_t uah, uint8_t top_state, uint8_t top_share);
+double energy_life_hours(const EN_Table *table, uint8_t node);
+int energy_shortest(const EN_Table *table, uint8_t *node, double *hours);
+const char *energy_state_name(uint8_t state);
+
+#endif /* ENERGY_H_ */
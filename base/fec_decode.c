@@ -0,0 +1,190 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Reed-Solomon decoding of frames built by fec_encode() on the nodes. The usual syndrome,
+ * Berlekamp-Massey, Chien search, and Forney steps, checked afterwards against the CRC.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "fec_decode.h"
+#include "../crc.h"
+
+static uint8_t gf_mul(uint8_t a, uint8_t b){
+    if(a == 0 || b == 0){
+        return 0;
+    }
+    return fec_exp[(fec_log[a] + fec_log[b]) % 255];
+}
+
+static uint8_t gf_div(uint8_t a, uint8_t b){
+    if(a == 0){
+        return 0;
+    }
+    return fec_exp[(fec_log[a] + 255 - fec_log[b]) % 255];
+}
+
+static uint8_t gf_pow_a(int p){
+    p %= 255;
+    if(p < 0){
+        p += 255;
+    }
+    return fec_exp[p];
+}
+
+// Evaluates a polynomial with coefficients lowest power first
+static uint8_t poly_eval(const uint8_t *p, int len, uint8_t x){
+    uint8_t y = 0;
+    int i;
+    for(i=len-1; i>=0; i--){
+        y = gf_mul(y, x) ^ p[i];
+    }
+    return y;
+}
+
+/*
+ * Corrects a codeword in place assuming nsym parity bytes. Returns the number of bytes corrected
+ * or -1 if there are too many errors.
+ */
+static int rs_correct(uint8_t *cw, int n, int nsym){
+    uint8_t synd[FEC_MAX_NSYM];
+    uint8_t lambda[FEC_MAX_NSYM+1] = {1}, prev[FEC_MAX_NSYM+1] = {1}, tmp[FEC_MAX_NSYM+1];
+    uint8_t omega[FEC_MAX_NSYM];
+    int i, j, errors = 0, nonzero = 0;
+
+    // Syndromes, S_j = c(a^j) with cw[0] the highest power
+    for(j=0; j<nsym; j++){
+        uint8_t s = 0, x = gf_pow_a(j);
+        for(i=0; i<n; i++){
+            s = gf_mul(s, x) ^ cw[i];
+        }
+        synd[j] = s;
+        nonzero |= s;
+    }
+    if(!nonzero){
+        return 0;
+    }
+
+    // Berlekamp-Massey for the error locator
+    int L = 0, m = 1;
+    uint8_t b = 1;
+    for(i=0; i<nsym; i++){
+        uint8_t d = synd[i];
+        for(j=1; j<=L; j++){
+            d ^= gf_mul(lambda[j], synd[i-j]);
+        }
+        if(d == 0){
+            m++;
+            continue;
+        }
+        uint8_t coef = gf_div(d, b);
+        memcpy(tmp, lambda, sizeof(tmp));
+        for(j=0; j+m<=nsym; j++){
+            lambda[j+m] ^= gf_mul(coef, prev[j]);
+        }
+        if(2*L <= i){
+            L = i + 1 - L;
+            memcpy(prev, tmp, sizeof(prev));
+            b = d;
+            m = 1;
+        }
+        else{
+            m++;
+        }
+    }
+    if(2*L > nsym){
+        return -1;
+    }
+
+    // Error evaluator, omega = S*lambda mod x^nsym
+    for(i=0; i<nsym; i++){
+        omega[i] = 0;
+        for(j=0; j<=i && j<=L; j++){
+            omega[i] ^= gf_mul(lambda[j], synd[i-j]);
+        }
+    }
+
+    // Chien search over the shortened positions and Forney for the magnitudes
+    for(i=0; i<n; i++){
+        int p = n - 1 - i;
+        uint8_t xinv = gf_pow_a(-p);
+        if(poly_eval(lambda, L+1, xinv) != 0){
+            continue;
+        }
+        uint8_t dl = 0;                     // Formal derivative keeps only the odd terms
+        for(j=1; j<=L; j+=2){
+            dl ^= gf_mul(lambda[j], gf_pow_a(-p*(j-1)));
+        }
+        if(dl == 0){
+            return -1;
+        }
+        uint8_t mag = gf_mul(gf_pow_a(p), gf_div(poly_eval(omega, nsym, xinv), dl));
+        cw[i] ^= mag;
+        errors++;
+    }
+    if(errors != L){
+        return -1;                          // Locator roots outside the shortened codeword
+    }
+    return errors;
+}
+
+/*
+ * Tries to decode a frame at one level. Returns the bytes corrected or -1.
+ */
+static int fec_try(const uint8_t *frame, uint8_t level, FEC_Result *result){
+    uint8_t cw[FEC_FRAME_SIZE];
+    uint8_t k = fec_capacity(level);
+    int corrected = 0;
+
+    memcpy(cw, frame, FEC_FRAME_SIZE);
+    if(FEC_NSYM(level) > 0){
+        corrected = rs_correct(cw, FEC_FRAME_SIZE, FEC_NSYM(level));
+        if(corrected < 0){
+            return -1;
+        }
+    }
+    if(cw[0] != fec_level_code[level]){
+        return -1;
+    }
+    uint16_t crc = ((uint16_t)cw[k+1] << 8) | cw[k+2];
+    if(crc16(cw, k+1) != crc){
+        return -1;
+    }
+    result->level = level;
+    result->corrected = corrected;
+    result->len = k;
+    memcpy(result->data, &cw[1], k);
+    return corrected;
+}
+
+/*
+ * Decodes a FEC_FRAME_SIZE byte frame. The level nearest to the received level code is tried
+ * first, then the rest. Returns the number of bytes corrected or -1 if the frame can't be recovered.
+ */
+int fec_decode(const uint8_t *frame, FEC_Result *result){
+    uint8_t order[FEC_LEVELS], dist[FEC_LEVELS];
+    int i, j;
+    for(i=0; i<FEC_LEVELS; i++){
+        order[i] = i;
+        dist[i] = __builtin_popcount(frame[0] ^ fec_level_code[i]);
+    }
+    for(i=1; i<FEC_LEVELS; i++){            // Insertion sort by distance
+        for(j=i; j>0 && dist[order[j]] < dist[order[j-1]]; j--){
+            uint8_t t = order[j];
+            order[j] = order[j-1];
+            order[j-1] = t;
+        }
+    }
+    for(i=0; i<FEC_LEVELS; i++){
+        int corrected = fec_try(frame, order[i], result);
+        if(corrected >= 0){
+            return corrected;
+        }
+    }
+    return -1;
+}
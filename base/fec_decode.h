@@ -0,0 +1,27 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Reed-Solomon decoding of frames built by fec_encode() on the nodes (see fec.h)
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include "../fec.h"
+
+#ifndef FEC_DECODE_H_
+#define FEC_DECODE_H_
+
+typedef struct FEC_ResultStruct{
+    uint8_t level;                      // Level the frame was sent at
+    uint8_t corrected;                  // Bytes corrected by the decoder
+    uint8_t len;                        // Data bytes, including padding (fec_capacity(level))
+    uint8_t data[FEC_FRAME_SIZE];
+} FEC_Result;
+
+int fec_decode(const uint8_t *frame, FEC_Result *result);
+
+#endif /* FEC_DECODE_H_ */
@@ -0,0 +1,81 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * flash.h implemented on a RAM copy of the MSP430G2553 address space
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <setjmp.h>
+#include "../flash.h"
+#include "flash_mem.h"
+
+uint8_t flash_mem[FLASH_MEM_SIZE];
+unsigned long flash_erases = 0;
+unsigned long flash_writes = 0;
+
+static long cut_ops = -1;
+static jmp_buf *cut_env = NULL;
+
+void flash_mem_reset(void){
+    memset(flash_mem, 0xFF, sizeof(flash_mem));
+    flash_erases = 0;
+    flash_writes = 0;
+    cut_ops = -1;
+    cut_env = NULL;
+}
+
+/*
+ * Simulates losing power: after ops more erases or byte writes, longjmp()s to env instead
+ */
+void flash_mem_cut_after(long ops, jmp_buf *env){
+    cut_ops = ops;
+    cut_env = env;
+}
+
+static void flash_mem_op(void){
+    if(cut_ops == 0){
+        cut_ops = -1;
+        longjmp(*cut_env, 1);
+    }
+    if(cut_ops > 0){
+        cut_ops--;
+    }
+}
+
+int flash_init(uint8_t mclk_mhz){
+    (void)mclk_mhz;
+    return 0;
+}
+
+int flash_erase(uint16_t addr){
+    uint16_t size = (addr >= 0x1000 && addr < 0x1100) ? FLASH_INFO_SIZE : FLASH_SEG_SIZE;
+    flash_mem_op();
+    memset(&flash_mem[addr & ~(size - 1)], 0xFF, size);
+    flash_erases++;
+    return 0;
+}
+
+int flash_write_byte(uint16_t addr, uint8_t value){
+    flash_mem_op();
+    flash_mem[addr] &= value;
+    flash_writes++;
+    return 0;
+}
+
+int flash_write(uint16_t addr, const uint8_t *data, uint16_t len){
+    uint16_t i;
+    for(i=0; i<len; i++){
+        flash_write_byte(addr + i, data[i]);
+    }
+    return 0;
+}
+
+uint8_t flash_read(uint16_t addr){
+    return flash_mem[addr];
+}
@@ -0,0 +1,29 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * flash.h implemented on a RAM copy of the MSP430G2553 address space, so node code that writes
+ * flash (ota.c, delta.c, boot.c) can run on a PC. Erases and writes behave like the real part:
+ * erases set a whole segment to 0xFF and writes can only clear bits.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <setjmp.h>
+
+#ifndef FLASH_MEM_H_
+#define FLASH_MEM_H_
+
+#define FLASH_MEM_SIZE      0x10000
+
+extern uint8_t flash_mem[FLASH_MEM_SIZE];
+extern unsigned long flash_erases;
+extern unsigned long flash_writes;
+
+void flash_mem_reset(void);
+void flash_mem_cut_after(long ops, jmp_buf *env);
+
+#endif /* FLASH_MEM_H_ */
@@ -0,0 +1,116 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Duplicate suppression and gap tracking for reports at the base station, see gap.h
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "../packet.h"
+#include "gap.h"
+
+void gap_init(GAP_Table *table){
+    memset(table, 0, sizeof(*table));
+}
+
+/*
+ * Starts a node's window over at a report
+ */
+static void gap_restart(GAP_Node *n, uint8_t seq, uint8_t boot, double time){
+    n->started = 1;
+    n->top = seq;
+    n->seen = 1;
+    n->span = 1;
+    n->boot_seq = seq;
+    n->boot_time = boot ? time : -1;
+    n->last = time;
+}
+
+/*
+ * Records a report from a node that arrived at time. Returns GAP_DUPLICATE if the report has been
+ * seen before and should be dropped, otherwise GAP_NEW or GAP_FILLED.
+ */
+int gap_update(GAP_Table *table, uint8_t node, uint8_t seq, uint8_t flags, double time){
+    GAP_Node *n = &table->nodes[node];
+    int8_t ahead = (int8_t)(seq - n->top);
+    uint8_t back;
+
+    if(!n->started){
+        gap_restart(n, seq, flags & PKT_F_BOOT, time);
+        n->reports++;
+        return GAP_NEW;
+    }
+    if(time - n->last > GAP_STALE_S){
+        gap_restart(n, seq, flags & PKT_F_BOOT, time);
+        n->resyncs++;
+        n->reports++;
+        return GAP_NEW;
+    }
+    n->last = time;
+    if((flags & PKT_F_BOOT) && !(flags & PKT_F_RESENT)
+       && !(seq == n->boot_seq && n->boot_time >= 0 && time - n->boot_time < GAP_BOOT_S)){
+        gap_restart(n, seq, 1, time);
+        n->restarts++;
+        n->reports++;
+        return GAP_NEW;
+    }
+    if(ahead > 0){
+        n->gaps += ahead - 1;
+        n->seen = (ahead >= GAP_WINDOW) ? 1 : (n->seen << ahead) | 1;
+        n->span = (n->span + ahead > GAP_WINDOW) ? GAP_WINDOW : n->span + ahead;
+        n->top = seq;
+        n->reports++;
+        return GAP_NEW;
+    }
+    back = -ahead;
+    if(back >= GAP_WINDOW){
+        gap_restart(n, seq, 0, time);
+        n->resyncs++;
+        n->reports++;
+        return GAP_NEW;
+    }
+    if(back >= n->span || (n->seen & (1ull << back))){
+        n->duplicates++;                // Or from before the window started, which can't be placed
+        return GAP_DUPLICATE;
+    }
+    n->seen |= 1ull << back;
+    n->filled++;
+    n->resent += (flags & PKT_F_RESENT) != 0;
+    n->reports++;
+    return GAP_FILLED;
+}
+
+/*
+ * Fills in the arguments of a PKT_CMD_RESEND for the reports a node is missing that it should still
+ * have. Call it after a report that wasn't itself resent, while the node listens. Returns the number
+ * of argument bytes, or 0 if there's nothing to ask for or the node was asked too recently.
+ */
+int gap_request(GAP_Table *table, uint8_t node, double now, uint8_t *args){
+    GAP_Node *n = &table->nodes[node];
+    uint8_t back, oldest = 0, mask = 0;
+
+    if(!n->started || (n->requests > 0 && now - n->asked < GAP_RETRY_S)){
+        return 0;
+    }
+    for(back=((n->span < PKT_RECENT) ? n->span : PKT_RECENT)-1; back>0; back--){
+        if(!(n->seen & (1ull << back))){
+            if(oldest == 0){
+                oldest = back;
+            }
+            mask |= 1 << (oldest - back);
+        }
+    }
+    if(mask == 0){
+        return 0;
+    }
+    args[0] = n->top - oldest;
+    args[1] = mask;
+    n->asked = now;
+    n->requests++;
+    return 2;
+}
@@ -0,0 +1,64 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Duplicate suppression and gap tracking for reports at the base station, by the per-node sequence
+ * numbers in the frame header (seq.h). Each node has a bitmap of which of the last GAP_WINDOW
+ * sequence numbers have arrived, so a copy of a report (a gateway retransmit, a relay, a catch-up
+ * burst after an outage) is dropped before its readings are queued for storage. Numbers skipped
+ * over are gaps; the ones still in the node's ring of PKT_RECENT reports are asked for again with
+ * one PKT_CMD_RESEND after the node's next report.
+ *
+ * Sequence numbers are 8 bits, so after GAP_STALE_S without a report from a node, or a report more
+ * than GAP_WINDOW behind the newest, the node is taken to have wrapped while out of touch and the
+ * window starts over. A late copy that old gets through. A PKT_F_BOOT report starts the window over
+ * too, unless it is a copy of the boot report that started the current one.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+
+#ifndef GAP_H_
+#define GAP_H_
+
+#define GAP_MAX_NODES       256
+#define GAP_WINDOW          64          // Sequence numbers of history per node, the bitmap's width
+#define GAP_STALE_S         21600.0     // Silence after which the numbering can't be trusted, < 128 reports at the fastest
+#define GAP_BOOT_S          30.0        // A boot report this soon after the last one with its number is a copy
+#define GAP_RETRY_S         1.0         // Don't ask a node again sooner, a report and its bounds come together
+
+#define GAP_NEW             0
+#define GAP_FILLED          1           // Arrived after a later report, resent or just late
+#define GAP_DUPLICATE       2
+
+typedef struct GAP_NodeStruct{
+    uint64_t seen;                      // Bit i set if report top - i has arrived
+    double last;                        // When the last report arrived
+    double boot_time;                   // When the boot report that started the window arrived, < 0 if none did
+    double asked;                       // When the node was last sent a PKT_CMD_RESEND
+    uint8_t top;                        // Newest sequence number seen
+    uint8_t span;                       // Sequence numbers since the window started, up to GAP_WINDOW
+    uint8_t boot_seq;
+    uint8_t started;
+    uint32_t reports;                   // Reports kept, including ones that filled a gap
+    uint32_t duplicates;                // Including reports from before the window started
+    uint32_t gaps;                      // Sequence numbers skipped over
+    uint32_t filled;
+    uint32_t resent;                    // Of filled, how many were answers to a PKT_CMD_RESEND
+    uint32_t restarts;                  // Boot reports after the first
+    uint32_t resyncs;                   // Reports too far behind or after too long to place
+    uint32_t requests;                  // PKT_CMD_RESENDs sent
+} GAP_Node;
+
+typedef struct GAP_TableStruct{
+    GAP_Node nodes[GAP_MAX_NODES];
+} GAP_Table;
+
+void gap_init(GAP_Table *table);
+int gap_update(GAP_Table *table, uint8_t node, uint8_t seq, uint8_t flags, double time);
+int gap_request(GAP_Table *table, uint8_t node, double now, uint8_t *args);
+
+#endif /* GAP_H_ */
@@ -0,0 +1,393 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Pipeline from the gateway's serial stream to storage, see ingest.h
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "../fec.h"
+#include "../packet.h"
+#include "fec_decode.h"
+#include "gap.h"
+#include "ingest.h"
+
+#define ING_SPINS           64          // Yields before a waiting stage starts sleeping
+#define ING_NAP_NS          200000      // Sleep between looks at a queue, a 4 KB chunk takes 44 ms at 921600 baud
+#define ING_POLL_MS         200         // How often the reader checks for a stop while the line is quiet
+
+#define ING_COUNT(counter, n)   atomic_fetch_add_explicit(&(counter), (n), memory_order_relaxed)
+#define ING_READ(counter)       atomic_load_explicit(&(counter), memory_order_relaxed)
+
+static double ing_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Waits a little for a queue. Yields at first so a busy pipeline doesn't pay for a sleep.
+ */
+static void ing_wait(unsigned *spins){
+    struct timespec ts = {0, ING_NAP_NS};
+    if(*spins < ING_SPINS){
+        (*spins)++;
+        sched_yield();
+        return;
+    }
+    nanosleep(&ts, NULL);
+}
+
+static int ing_failed(ING_Pipeline *p){
+    return atomic_load_explicit(&p->error, memory_order_relaxed);
+}
+
+/*
+ * Sends a node a control frame for the gateway to put on the air in the node's listen window
+ */
+static void ing_send(ING_Pipeline *p, uint8_t node, uint8_t cmd, const uint8_t *args, uint8_t nargs){
+    PKT_Frame pkt;
+    uint8_t air[FEC_FRAME_SIZE];
+    uint8_t out[FEC_FRAME_SIZE + SER_OVERHEAD];
+    int len;
+
+    if(p->out_fd >= 0){
+        pkt_control_init(&pkt, node, cmd, args, nargs);
+        fec_encode(0, pkt.buf, pkt.len, air);
+        len = ser_frame(air, FEC_FRAME_SIZE, out);
+        if(write(p->out_fd, out, len) != len){
+            return;                     // Lost, the same as a control frame lost on the air
+        }
+    }
+}
+
+/*
+ * Checks a report against the ones already queued and asks the node for any it's missing. Returns
+ * GAP_DUPLICATE if it's a copy that should be dropped.
+ */
+static int ing_dedup(ING_Pipeline *p, const PKT_Report *report, double time){
+    GAP_Node *n = &p->gaps.nodes[report->node];
+    uint32_t gaps = n->gaps;
+    uint8_t args[2];
+    int res = gap_update(&p->gaps, report->node, report->seq, report->flags, time);
+
+    ING_COUNT(p->gap_seqs, n->gaps - gaps);
+    if(res == GAP_DUPLICATE){
+        ING_COUNT(p->duplicates, 1);
+        return res;
+    }
+    if(res == GAP_FILLED){
+        ING_COUNT(p->filled, 1);
+    }
+    if(!(report->flags & PKT_F_RESENT) && gap_request(&p->gaps, report->node, time, args) > 0){
+        ing_send(p, report->node, PKT_CMD_RESEND, args, sizeof(args));
+        ING_COUNT(p->resends, 1);
+    }
+    return res;
+}
+
+/*
+ * Decodes an air frame from the gateway and queues its readings
+ */
+static void ing_frame(ING_Pipeline *p, const uint8_t *air, int len, double time){
+    FEC_Result res;
+    PKT_Report report;
+    ING_Record rec;
+    unsigned spins;
+    uint8_t i, node, level;
+    int corrected, changed, dedup;
+
+    if(len != FEC_FRAME_SIZE){
+        ING_COUNT(p->bad_size, 1);
+        return;
+    }
+    corrected = fec_decode(air, &res);
+    if(corrected < 0){
+        ING_COUNT(p->fec_failed, 1);
+        link_suspect(&p->links, air[1]);    // Best guess at the sender, counted if it checks out
+        return;
+    }
+    ING_COUNT(p->corrected, corrected);
+    node = res.data[0];
+    changed = link_update(&p->links, node, corrected);
+    if(changed){
+        level = link_level(&p->links, node);
+        ing_send(p, node, PKT_CMD_FEC, &level, 1);
+        ING_COUNT(p->fec_changes, 1);
+    }
+    if(pkt_type(res.data, res.len) != PKT_REPORT){
+        return;                         // OTA status is only of interest to otadelta's sender
+    }
+    if(pkt_report_parse(res.data, res.len, &report) != 0){
+        ING_COUNT(p->malformed, 1);
+        return;
+    }
+    ING_COUNT(p->reports, 1);
+    dedup = ing_dedup(p, &report, time);
+    if(dedup == GAP_DUPLICATE){
+        return;
+    }
+    if((report.flags & PKT_F_ENERGY) && dedup == GAP_NEW){     // A late summary is older than the last one
+        pthread_mutex_lock(&p->energy_lock);
+        energy_update(&p->energy, node, time, report.charge_uah, report.top_state, report.top_share);
+        pthread_mutex_unlock(&p->energy_lock);
+    }
+
+    rec.time = time;
+    rec.node = report.node;
+    for(i=0; i<report.count; i++){
+        rec.sensor = report.readings[i].sensor;
+        rec.value = report.readings[i].value;
+        spins = 0;
+        while(spsc_push(&p->records, &rec) != 0){
+            if(ing_failed(p)){
+                return;
+            }
+            ing_wait(&spins);
+        }
+    }
+}
+
+static void *ing_reader(void *arg){
+    ING_Pipeline *p = arg;
+    ING_Chunk chunk;
+    struct pollfd pfd = {p->in_fd, POLLIN, 0};
+    unsigned spins;
+    ssize_t n;
+    int ready, idle = 1;
+
+    while(!atomic_load(&p->stop) && !ing_failed(p)){
+        ready = poll(&pfd, 1, ING_POLL_MS);
+        if(ready < 0 && errno == EINTR){
+            continue;
+        }
+        if(ready == 0){
+            chunk.len = 0;              // Empty chunk tells the decoder the line went quiet
+            if(!idle && spsc_push(&p->chunks, &chunk) == 0){
+                idle = 1;
+            }
+            continue;
+        }
+        n = read(p->in_fd, chunk.data, ING_CHUNK_SIZE);
+        if(n < 0 && errno == EINTR){
+            continue;
+        }
+        if(n < 0){
+            atomic_store(&p->error, 1);
+            break;
+        }
+        if(n == 0){
+            break;                      // End of a file or pipe
+        }
+        chunk.time = ing_now();
+        chunk.len = n;
+        idle = 0;
+        ING_COUNT(p->bytes, n);
+        spins = 0;
+        while(spsc_push(&p->chunks, &chunk) != 0 && !ing_failed(p)){
+            ing_wait(&spins);           // Backpressure, the kernel buffers the line meanwhile
+        }
+    }
+    spsc_close(&p->chunks);
+    return NULL;
+}
+
+/*
+ * Finishes up what the reframer holds once the line goes quiet or the input ends
+ */
+static void ing_idle(ING_Pipeline *p, double time){
+    const uint8_t *payload;
+    int n;
+    while((n = ser_reframe_idle(&p->reframer, &payload)) >= 0){
+        ing_frame(p, payload, n, time);
+    }
+}
+
+static void *ing_decoder(void *arg){
+    ING_Pipeline *p = arg;
+    ING_Chunk chunk;
+    SER_Reframer *r = &p->reframer;
+    const uint8_t *payload;
+    unsigned spins = 0;
+    size_t pos, used;
+    double last = 0;                    // Time of the last bytes, for frames finished by ing_idle()
+    int n;
+
+    while(!ing_failed(p)){
+        if(spsc_pop(&p->chunks, &chunk) != 0){
+            if(spsc_done(&p->chunks)){
+                ing_idle(p, last);
+                break;
+            }
+            ing_wait(&spins);
+            continue;
+        }
+        spins = 0;
+        if(chunk.len == 0){
+            ing_idle(p, last);
+        }
+        else{
+            last = chunk.time;
+            pos = 0;
+            while((n = ser_reframe(r, &chunk.data[pos], chunk.len - pos, &used, &payload)) >= 0){
+                pos += used;
+                ing_frame(p, payload, n, chunk.time);
+            }
+        }
+        atomic_store_explicit(&p->frames, r->frames, memory_order_relaxed);
+        atomic_store_explicit(&p->bad_crc, r->bad_crc, memory_order_relaxed);
+        atomic_store_explicit(&p->skipped, r->skipped, memory_order_relaxed);
+    }
+    atomic_store_explicit(&p->frames, r->frames, memory_order_relaxed);
+    atomic_store_explicit(&p->bad_crc, r->bad_crc, memory_order_relaxed);
+    atomic_store_explicit(&p->skipped, r->skipped, memory_order_relaxed);
+    spsc_close(&p->records);
+    return NULL;
+}
+
+static void *ing_writer(void *arg){
+    ING_Pipeline *p = arg;
+    ING_Record batch[ING_BATCH];
+    unsigned spins = 0;
+    size_t n;
+
+    while(!ing_failed(p)){
+        for(n=0; n<ING_BATCH && spsc_pop(&p->records, &batch[n]) == 0; n++){
+        }
+        if(n > 0){
+            spins = 0;
+            if(p->sink(p->sink_ctx, batch, n) != 0){
+                atomic_store(&p->error, 1);
+                break;
+            }
+            ING_COUNT(p->written, n);
+            continue;
+        }
+        if(spsc_done(&p->records)){
+            break;
+        }
+        ing_wait(&spins);
+    }
+    atomic_store(&p->done, 1);
+    return NULL;
+}
+
+/*
+ * Starts the three stages reading from in_fd. FEC level changes are written to out_fd for the
+ * gateway to send, or dropped if out_fd is -1.
+ */
+int ingest_start(ING_Pipeline *p, int in_fd, int out_fd, ING_Sink sink, void *sink_ctx){
+    memset(p, 0, sizeof(*p));
+    p->in_fd = in_fd;
+    p->out_fd = out_fd;
+    p->sink = sink;
+    p->sink_ctx = sink_ctx;
+    ser_reframe_init(&p->reframer);
+    link_init(&p->links);
+    gap_init(&p->gaps);
+    energy_init(&p->energy, EN_CAPACITY_MAH);
+    pthread_mutex_init(&p->energy_lock, NULL);
+    atomic_init(&p->stop, 0);
+    atomic_init(&p->error, 0);
+    atomic_init(&p->done, 0);
+    if(spsc_init(&p->chunks, sizeof(ING_Chunk), ING_CHUNKS) != 0){
+        return -1;
+    }
+    if(spsc_init(&p->records, sizeof(ING_Record), ING_RECORDS) != 0){
+        spsc_free(&p->chunks);
+        return -1;
+    }
+    if(pthread_create(&p->writer, NULL, ing_writer, p) != 0){
+        goto fail;
+    }
+    if(pthread_create(&p->decoder, NULL, ing_decoder, p) != 0){
+        atomic_store(&p->error, 1);
+        pthread_join(p->writer, NULL);
+        goto fail;
+    }
+    if(pthread_create(&p->reader, NULL, ing_reader, p) != 0){
+        atomic_store(&p->error, 1);
+        pthread_join(p->decoder, NULL);
+        pthread_join(p->writer, NULL);
+        goto fail;
+    }
+    return 0;
+
+fail:
+    spsc_free(&p->chunks);
+    spsc_free(&p->records);
+    return -1;
+}
+
+/*
+ * Stops reading. Whatever was already read is still decoded and written.
+ */
+void ingest_stop(ING_Pipeline *p){
+    atomic_store(&p->stop, 1);
+}
+
+/*
+ * Returns 1 once everything read has been written, or a stage failed
+ */
+int ingest_done(ING_Pipeline *p){
+    return atomic_load(&p->done);
+}
+
+/*
+ * Waits for the pipeline to finish, at the end of the input or after ingest_stop(). Returns -1 if
+ * a stage failed.
+ */
+int ingest_join(ING_Pipeline *p){
+    pthread_join(p->reader, NULL);
+    pthread_join(p->decoder, NULL);
+    pthread_join(p->writer, NULL);
+    spsc_free(&p->chunks);
+    spsc_free(&p->records);
+    return ing_failed(p) ? -1 : 0;
+}
+
+/*
+ * Snapshot of the counters, safe to take while the pipeline runs
+ */
+void ingest_stats(ING_Pipeline *p, ING_Stats *stats){
+    stats->bytes = ING_READ(p->bytes);
+    stats->frames = ING_READ(p->frames);
+    stats->bad_crc = ING_READ(p->bad_crc);
+    stats->skipped = ING_READ(p->skipped);
+    stats->bad_size = ING_READ(p->bad_size);
+    stats->fec_failed = ING_READ(p->fec_failed);
+    stats->corrected = ING_READ(p->corrected);
+    stats->reports = ING_READ(p->reports);
+    stats->malformed = ING_READ(p->malformed);
+    stats->records = ING_READ(p->written);
+    stats->fec_changes = ING_READ(p->fec_changes);
+    stats->duplicates = ING_READ(p->duplicates);
+    stats->gaps = ING_READ(p->gap_seqs);
+    stats->filled = ING_READ(p->filled);
+    stats->resends = ING_READ(p->resends);
+    stats->chunk_waits = ING_READ(p->chunks.full);
+    stats->record_waits = ING_READ(p->records.full);
+    stats->chunk_high = ING_READ(p->chunks.high_water);
+    stats->record_high = ING_READ(p->records.high_water);
+}
+
+/*
+ * Copies the battery life table the decoder keeps, for reporting while the pipeline runs
+ */
+void ingest_energy(ING_Pipeline *p, EN_Table *copy){
+    pthread_mutex_lock(&p->energy_lock);
+    *copy = p->energy;
+    pthread_mutex_unlock(&p->energy_lock);
+}
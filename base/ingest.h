@@ -0,0 +1,109 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Pipeline from the gateway's serial stream to storage, as three threads:
+ *
+ *  reader      read()s the serial port (or a file or pipe) into time stamped chunks
+ *  decoder     reframes (serial.h), FEC decodes, updates the link and energy tables, answers with
+ *              FEC level changes, drops duplicate reports and asks for missing ones (gap.h), and
+ *              turns reports into records
+ *  writer      hands batches of records to a sink that persists them
+ *
+ * Each pair is joined by a lock-free single producer, single consumer queue (spsc.h). A stage that
+ * finds the next queue full waits for it rather than dropping anything, and the waits are counted,
+ * so the reader only falls behind the serial line (and the kernel's buffer starts filling) if the
+ * writer can't keep up for longer than both queues can absorb.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "spsc.h"
+#include "serial.h"
+#include "link.h"
+#include "gap.h"
+#include "energy.h"
+
+#ifndef INGEST_H_
+#define INGEST_H_
+
+#define ING_CHUNK_SIZE      4096        // Bytes per read()
+#define ING_CHUNKS          256         // Reader to decoder queue, 1 MB
+#define ING_RECORDS         65536       // Decoder to writer queue
+#define ING_BATCH           1024        // Most records handed to the sink at once
+
+typedef struct ING_RecordStruct{
+    double time;                        // Seconds since the epoch the frame was read off the UART, even
+                                        // for a resent report, so records stay in order for the store
+    uint8_t node;
+    uint8_t sensor;                     // packet.h sensor ID, including PKT_SEN_PERIOD etc.
+    int16_t value;
+} ING_Record;
+
+typedef struct ING_ChunkStruct{
+    double time;
+    uint32_t len;
+    uint8_t data[ING_CHUNK_SIZE];
+} ING_Chunk;
+
+// Persists a batch of records. Returns -1 on an error, which stops the pipeline.
+typedef int (*ING_Sink)(void *ctx, const ING_Record *records, size_t n);
+
+typedef struct ING_StatsStruct{
+    uint64_t bytes;
+    uint64_t frames;                    // Serial frames with a good CRC
+    uint64_t bad_crc;                   // Serial frames with a bad CRC
+    uint64_t skipped;                   // Bytes thrown away hunting for a serial sync
+    uint64_t bad_size;                  // Serial frames that weren't a whole air frame
+    uint64_t fec_failed;                // Air frames that couldn't be corrected
+    uint64_t corrected;                 // Bytes corrected by the FEC
+    uint64_t reports;
+    uint64_t malformed;                 // Air frames that decoded but didn't parse
+    uint64_t records;                   // Records written by the sink
+    uint64_t fec_changes;               // FEC level changes sent to nodes
+    uint64_t duplicates;                // Reports dropped as copies of ones already queued
+    uint64_t gaps;                      // Reports found missing from a node's sequence
+    uint64_t filled;                    // Missing reports that arrived later
+    uint64_t resends;                   // PKT_CMD_RESENDs sent to nodes
+    uint64_t chunk_waits;               // Times the reader waited for room in the chunk queue
+    uint64_t record_waits;              // Times the decoder waited for room in the record queue
+    size_t chunk_high;                  // Most chunks ever queued
+    size_t record_high;                 // Most records ever queued
+} ING_Stats;
+
+typedef struct ING_PipelineStruct{
+    int in_fd;
+    int out_fd;                         // Where FEC changes are sent back to the gateway, -1 for nowhere
+    ING_Sink sink;
+    void *sink_ctx;
+    SPSC_Queue chunks;
+    SPSC_Queue records;
+    SER_Reframer reframer;              // Decoder's
+    LINK_Table links;                   // Decoder's
+    GAP_Table gaps;                     // Decoder's
+    EN_Table energy;                    // Decoder's, read by others through ingest_energy()
+    pthread_mutex_t energy_lock;
+    pthread_t reader, decoder, writer;
+    atomic_int stop;                    // Reader stops at the next read, the rest drain
+    atomic_int error;                   // Set by a stage that failed
+    atomic_int done;                    // Writer has finished
+    // Counters, each only written by one stage
+    atomic_uint_fast64_t bytes, bad_size, fec_failed, corrected, reports, malformed, written, fec_changes;
+    atomic_uint_fast64_t duplicates, gap_seqs, filled, resends;
+    atomic_uint_fast64_t frames, bad_crc, skipped;
+} ING_Pipeline;
+
+int ingest_start(ING_Pipeline *p, int in_fd, int out_fd, ING_Sink sink, void *sink_ctx);
+void ingest_stop(ING_Pipeline *p);
+int ingest_done(ING_Pipeline *p);
+int ingest_join(ING_Pipeline *p);
+void ingest_stats(ING_Pipeline *p, ING_Stats *stats);
+void ingest_energy(ING_Pipeline *p, EN_Table *copy);
+
+#endif /* INGEST_H_ */
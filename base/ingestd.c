@@ -0,0 +1,302 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Base station ingestion daemon. Reads the gateway node's serial stream (or a file or pipe standing in
+ * for it), decodes the node reports, and appends every reading to a time series store (tsdb.h), a CSV
+ * file as time,node,sensor,value, or both. Control frames for the nodes (FEC level changes, resend
+ * requests) are written back to the gateway when reading a serial port, or with -r to a file or pipe
+ * for whatever stands in for the gateway. Runs in the foreground until the input ends or it gets SIGINT or SIGTERM,
+ * and prints the pipeline counters (ingest.h) to stderr every few seconds with -v and always on exit.
+ *
+ * With -e, every node's battery life projection (energy.h) is written to a CSV file (replaced whole)
+ * every few seconds as node,charge_mah,rate_ua,life_h,top_state,top_share, where top_state is the
+ * power state that drew the most charge in the node's last energy summary and top_share its percent.
+ * The node with the least life left is in the stats output too.
+ *
+ * With -m, trail conditions (trail.h) are kept up to date for the segments in the map file, and with
+ * -w they are written to a CSV file (replaced whole) whenever one of them might have changed, as
+ * segment,condition,temp,temp_min,temp_max,freeze_thaw,hours_above_0,new_snow_mm,depth_change_mm.
+ *
+ * usage: ingestd [-b baud] [-d store.ts] [-o readings.csv] [-e energy.csv] [-m segment map]
+ *                [-w conditions.csv] [-r replies] [-v stats period s] port_or_file
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include "ingest.h"
+#include "energy.h"
+#include "serial.h"
+#include "tsdb.h"
+#include "trail.h"
+
+#define SYNC_EVERY          100         // Ticks of the main loop between store syncs, 10 s
+#define TRAIL_EVERY         10          // Ticks between sliding the trail windows along, 1 s
+#define ENERGY_EVERY        100         // Ticks between rewrites of the energy file, 10 s
+
+typedef struct SinkStruct{
+    FILE *csv;                          // NULL for none
+    TS_DB *db;                          // NULL for none
+    TR_Model *trail;                    // NULL for none
+    pthread_mutex_t trail_lock;         // Writer thread updates, main thread slides and publishes
+} Sink;
+
+static volatile sig_atomic_t quit = 0;
+
+static void on_signal(int sig){
+    (void)sig;
+    quit = 1;
+}
+
+/*
+ * Appends records to the store and the CSV file. The CSV file is flushed once per batch so a quiet line
+ * doesn't hold readings back. A reading older than the last one of its series (the clock stepped
+ * back) is left out of the store rather than stopping the daemon.
+ */
+static int sink(void *ctx, const ING_Record *records, size_t n){
+    Sink *k = ctx;
+    size_t i;
+    for(i=0; i<n; i++){
+        if(k->db != NULL){
+            ts_append(k->db, records[i].node, records[i].sensor, records[i].time, records[i].value);
+        }
+        if(k->csv != NULL){
+            fprintf(k->csv, "%.3f,%u,%u,%d\n", records[i].time, records[i].node, records[i].sensor, records[i].value);
+        }
+    }
+    if(k->trail != NULL){
+        pthread_mutex_lock(&k->trail_lock);
+        for(i=0; i<n; i++){
+            trail_update(k->trail, records[i].node, records[i].sensor, records[i].time, records[i].value);
+        }
+        pthread_mutex_unlock(&k->trail_lock);
+    }
+    return (k->csv == NULL || fflush(k->csv) == 0) ? 0 : -1;
+}
+
+/*
+ * Works out the segments that need it and replaces the conditions file. Called with the lock held.
+ */
+static int write_conditions(TR_Model *m, const char *path){
+    char tmp[4096];
+    TR_Inputs in;
+    TR_Condition c;
+    FILE *f;
+    uint8_t i;
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    if((f = fopen(tmp, "w")) == NULL){
+        return -1;
+    }
+    fprintf(f, "segment,condition,temp,temp_min,temp_max,freeze_thaw,hours_above_0,new_snow_mm,depth_change_mm\n");
+    for(i=0; i<m->nsegments; i++){
+        c = trail_condition(m, i, &in);
+        fprintf(f, "%s,%s", m->segments[i].name, trail_condition_name(c));
+        if(in.have_temp){
+            fprintf(f, ",%d,%d,%d,%u,%.1f", in.temp, in.temp_min, in.temp_max, in.freeze_thaw, in.above_tenths / 10.0);
+        }
+        else{
+            fprintf(f, ",,,,,");
+        }
+        if(in.have_depth){
+            fprintf(f, ",%d,%d\n", in.new_snow, in.depth_change);
+        }
+        else{
+            fprintf(f, ",,\n");
+        }
+    }
+    if(fclose(f) != 0){
+        return -1;
+    }
+    return rename(tmp, path);           // Readers never see half a file
+}
+
+/*
+ * Replaces the energy file with every node that has sent a summary
+ */
+static int write_energy(const EN_Table *t, const char *path){
+    char tmp[4096];
+    const EN_Node *n;
+    double life;
+    FILE *f;
+    int i;
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    if((f = fopen(tmp, "w")) == NULL){
+        return -1;
+    }
+    fprintf(f, "node,charge_mah,rate_ua,life_h,top_state,top_share\n");
+    for(i=0; i<EN_MAX_NODES; i++){
+        n = &t->nodes[i];
+        if(!n->seen){
+            continue;
+        }
+        fprintf(f, "%d,%.3f,", i, n->last_uah / 1000.0);
+        life = energy_life_hours(t, i);
+        if(life >= 0){
+            fprintf(f, "%.1f,%.0f", n->rate_uah_per_h, life);   // uAh per hour is uA
+        }
+        else{
+            fprintf(f, ",");                                    // Needs a second summary
+        }
+        fprintf(f, ",%s,%u\n", energy_state_name(n->top_state), n->top_share);
+    }
+    if(fclose(f) != 0){
+        return -1;
+    }
+    return rename(tmp, path);
+}
+
+static void print_stats(ING_Pipeline *p){
+    static EN_Table energy;
+    ING_Stats s;
+    uint8_t node;
+    double hours;
+    int projected;
+
+    ingest_stats(p, &s);
+    ingest_energy(p, &energy);
+    fprintf(stderr, "%llu bytes, %llu frames (%llu bad CRC, %llu bytes skipped, %llu wrong size), "
+            "%llu FEC failures, %llu bytes corrected, %llu reports (%llu malformed, %llu duplicates), "
+            "%llu missing (%llu filled), %llu records, %llu FEC changes, %llu resend requests, "
+            "waits %llu chunk %llu record, high water %zu/%d chunks %zu/%d records\n",
+            (unsigned long long)s.bytes, (unsigned long long)s.frames, (unsigned long long)s.bad_crc,
+            (unsigned long long)s.skipped, (unsigned long long)s.bad_size, (unsigned long long)s.fec_failed,
+            (unsigned long long)s.corrected, (unsigned long long)s.reports, (unsigned long long)s.malformed,
+            (unsigned long long)s.duplicates, (unsigned long long)s.gaps, (unsigned long long)s.filled,
+            (unsigned long long)s.records, (unsigned long long)s.fec_changes, (unsigned long long)s.resends,
+            (unsigned long long)s.chunk_waits,
+            (unsigned long long)s.record_waits, s.chunk_high, ING_CHUNKS, s.record_high, ING_RECORDS);
+    projected = energy_shortest(&energy, &node, &hours);
+    if(projected > 0){
+        fprintf(stderr, "battery life projected for %d nodes, shortest node %u with %.0f h left at %.1f uA, "
+                "mostly %s (%u%%)\n", projected, node, hours, energy.nodes[node].rate_uah_per_h,
+                energy_state_name(energy.nodes[node].top_state), energy.nodes[node].top_share);
+    }
+}
+
+int main(int argc, char **argv){
+    static ING_Pipeline pipe;
+    static TS_DB db;
+    static TR_Model trail;
+    static EN_Table energy;
+    const char *out = NULL, *store = NULL, *map = NULL, *conditions = NULL, *replies = NULL, *energy_csv = NULL;
+    long baud = 115200;
+    int every = 0, since = 0, ticks = 0, opt, in_fd, out_fd;
+    Sink k = {NULL, NULL, NULL, PTHREAD_MUTEX_INITIALIZER};
+    struct timespec tick = {0, 100000000};
+
+    while((opt = getopt(argc, argv, "b:d:o:e:m:w:r:v:")) != -1){
+        switch(opt){
+            case 'b': baud = atol(optarg); break;
+            case 'd': store = optarg; break;
+            case 'o': out = optarg; break;
+            case 'e': energy_csv = optarg; break;
+            case 'm': map = optarg; break;
+            case 'w': conditions = optarg; break;
+            case 'r': replies = optarg; break;
+            case 'v': every = atoi(optarg) * 10; break;
+            default:
+                fprintf(stderr, "usage: %s [-b baud] [-d store.ts] [-o readings.csv] [-e energy.csv] [-m segment map] [-w conditions.csv] [-r replies] [-v stats period s] port_or_file\n", argv[0]);
+                return 2;
+        }
+    }
+    if(argc - optind != 1){
+        fprintf(stderr, "usage: %s [-b baud] [-d store.ts] [-o readings.csv] [-e energy.csv] [-m segment map] [-w conditions.csv] [-r replies] [-v stats period s] port_or_file\n", argv[0]);
+        return 2;
+    }
+    in_fd = ser_open(argv[optind], baud);
+    if(in_fd < 0){
+        fprintf(stderr, "can't open %s at %ld baud\n", argv[optind], baud);
+        return 1;
+    }
+    out_fd = isatty(in_fd) ? in_fd : -1;    // A file or pipe only gets replies with -r
+    if(replies != NULL && (out_fd = ser_open_reply(replies)) < 0){
+        fprintf(stderr, "can't open %s for replies\n", replies);
+        return 1;
+    }
+    if(out != NULL && (k.csv = fopen(out, "a")) == NULL){
+        fprintf(stderr, "can't open %s\n", out);
+        return 1;
+    }
+    if(store != NULL){
+        if(ts_open(&db, store, 1) != 0){
+            fprintf(stderr, "can't open a store at %s\n", store);
+            return 1;
+        }
+        k.db = &db;
+    }
+    if(map != NULL){
+        trail_init(&trail, TR_WINDOW_H);
+        if(trail_load(&trail, map) != 0){
+            fprintf(stderr, "can't read the segment map %s\n", map);
+            return 1;
+        }
+        k.trail = &trail;
+    }
+    if(out == NULL && store == NULL){
+        k.csv = stdout;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    if(ingest_start(&pipe, in_fd, out_fd, sink, &k) != 0){
+        fprintf(stderr, "can't start the pipeline\n");
+        return 1;
+    }
+    while(!quit && !ingest_done(&pipe)){
+        nanosleep(&tick, NULL);
+        if(every > 0 && ++since >= every){
+            since = 0;
+            print_stats(&pipe);
+        }
+        ticks++;
+        if(k.db != NULL && ticks % SYNC_EVERY == 0){
+            ts_sync(k.db);
+        }
+        if(energy_csv != NULL && ticks % ENERGY_EVERY == 0){
+            ingest_energy(&pipe, &energy);
+            if(write_energy(&energy, energy_csv) != 0){
+                fprintf(stderr, "can't write %s\n", energy_csv);
+            }
+        }
+        if(k.trail != NULL && ticks % TRAIL_EVERY == 0){
+            pthread_mutex_lock(&k.trail_lock);
+            trail_advance(k.trail, time(NULL));
+            if(conditions != NULL && trail_dirty(k.trail) && write_conditions(k.trail, conditions) != 0){
+                fprintf(stderr, "can't write %s\n", conditions);
+            }
+            pthread_mutex_unlock(&k.trail_lock);
+        }
+    }
+    ingest_stop(&pipe);
+    int err = ingest_join(&pipe);
+    print_stats(&pipe);
+    if(energy_csv != NULL){
+        ingest_energy(&pipe, &energy);
+        write_energy(&energy, energy_csv);
+    }
+    if(k.db != NULL){
+        ts_close(k.db);
+    }
+    if(k.trail != NULL){
+        if(conditions != NULL && trail_dirty(k.trail)){
+            write_conditions(k.trail, conditions);
+        }
+        trail_free(k.trail);
+    }
+    if(err){
+        fprintf(stderr, "stopped on an error\n");
+        return 1;
+    }
+    return 0;
+}
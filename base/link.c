@@ -0,0 +1,102 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Per-link loss statistics at the base station and the FEC level chosen from them
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "../fec.h"
+#include "link.h"
+
+/*
+ * Every node boots at the most robust level (main.c), so that's where the table starts
+ */
+void link_init(LINK_Table *table){
+    uint16_t i;
+    memset(table, 0, sizeof(*table));
+    for(i=0; i<LINK_MAX_NODES; i++){
+        table->nodes[i].level = FEC_LEVELS - 1;
+    }
+}
+
+/*
+ * Level needed for a frame that had a number of bytes corrected, keeping one byte of margin.
+ * A level corrects 2 bytes per step.
+ */
+static uint8_t link_need(uint8_t corrected){
+    if(corrected == 0){
+        return 0;
+    }
+    if(corrected == LINK_FAILED || (corrected + 2) / 2 >= FEC_LEVELS){
+        return FEC_LEVELS - 1;
+    }
+    return (corrected + 2) / 2;
+}
+
+/*
+ * Adds one frame to a node's window of history
+ */
+static void link_record(LINK_Node *n, uint8_t hist){
+    n->frames++;
+    n->hist[n->pos] = hist;
+    n->pos = (n->pos + 1) % LINK_WINDOW;
+    if(n->since_change < 0xFF){
+        n->since_change++;
+    }
+}
+
+/*
+ * Records a frame from a node that fec_decode() corrected a number of bytes in, along with any
+ * suspect failures the frame confirms. Returns 1 if the node should be sent a new FEC level,
+ * otherwise 0.
+ */
+int link_update(LINK_Table *table, uint8_t node, int corrected){
+    LINK_Node *n = &table->nodes[node];
+    uint8_t i, target = 0;
+
+    for(; n->suspects > 0; n->suspects--){
+        n->failures++;
+        link_record(n, LINK_FAILED);
+    }
+    n->corrected += corrected;
+    link_record(n, (corrected >= LINK_FAILED) ? LINK_FAILED - 1 : corrected);
+
+    for(i=0; i<LINK_WINDOW; i++){
+        uint8_t need = link_need(n->hist[i]);
+        if(need > target){
+            target = need;
+        }
+    }
+    if(target > n->level){
+        n->level = target;
+        n->since_change = 0;
+        return 1;
+    }
+    if(target < n->level && n->since_change >= LINK_WINDOW){
+        n->level--;
+        n->since_change = 0;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Holds a frame that couldn't be decoded against the node its header names, until a good frame
+ * from the node confirms it. Only a window's worth are kept.
+ */
+void link_suspect(LINK_Table *table, uint8_t node){
+    LINK_Node *n = &table->nodes[node];
+    if(n->suspects < LINK_WINDOW){
+        n->suspects++;
+    }
+}
+
+uint8_t link_level(const LINK_Table *table, uint8_t node){
+    return table->nodes[node].level;
+}
@@ -0,0 +1,47 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Per-link loss statistics at the base station and the FEC level chosen from them. The level is
+ * raised as soon as a frame needs more correction than the margin allows, and lowered one step at
+ * a time after a full window of frames that would have been fine at the lower level.
+ *
+ * A frame that couldn't be decoded only has its uncorrected header to say who sent it, so it is held
+ * as a suspect against that node and counted once a good frame from the node confirms it exists. A
+ * corrupted node ID then never moves another node's level or draws a spurious PKT_CMD_FEC.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+
+#ifndef LINK_H_
+#define LINK_H_
+
+#define LINK_MAX_NODES      256
+#define LINK_WINDOW         16          // Frames of history the level is chosen from
+#define LINK_FAILED         0xFF        // Corrected count for a frame that couldn't be decoded
+
+typedef struct LINK_NodeStruct{
+    uint8_t level;                      // FEC level the node was last told to use
+    uint8_t hist[LINK_WINDOW];          // Bytes corrected in the most recent frames
+    uint8_t pos;
+    uint8_t since_change;               // Frames since the level last changed
+    uint8_t suspects;                   // Undecodable frames that looked like the node's, not yet confirmed
+    uint32_t frames;
+    uint32_t failures;
+    uint32_t corrected;                 // Total bytes corrected
+} LINK_Node;
+
+typedef struct LINK_TableStruct{
+    LINK_Node nodes[LINK_MAX_NODES];
+} LINK_Table;
+
+void link_init(LINK_Table *table);
+int link_update(LINK_Table *table, uint8_t node, int corrected);
+void link_suspect(LINK_Table *table, uint8_t node);
+uint8_t link_level(const LINK_Table *table, uint8_t node);
+
+#endif /* LINK_H_ */
@@ -0,0 +1,711 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Load for the base station beyond what the real nodes produce. Generates the serial stream a gateway
+ * would send (serial.h frames around fec.h codewords of packet.h reports) or replays a capture of a
+ * real one, and either writes it out paced at a multiple of real time or, with -b, drives the
+ * ingestion pipeline (ingest.h) and a store (tsdb.h) in this process as a benchmark.
+ *
+ * The generated stream has
+ *  - -n nodes reporting temperature and snow depth with their sampling periods about every -p s, an
+ *    energy summary every 6th report, and their sampling bounds at boot, the way main.c does. Each
+ *    node sends at a FEC level of its own.
+ *  - the serial line's pace, so frames queue behind each other at -B baud
+ *  - base station outages of -g s every -G s. The gateway holds on to what it hears meanwhile and
+ *    sends it all back to back when the base station comes back.
+ *  - -c of the frames corrupted: bytes hit on the air (sometimes more than the FEC can correct), a
+ *    byte of the serial frame damaged, or the serial frame's tail lost
+ *  - -u of the frames sent twice, as a relay or a retransmit would, which ingestion drops (gap.h)
+ *
+ * Captures are "TRAILCAP" and then every chunk of bytes as an LG_ChunkHeader followed by the bytes.
+ * -R records one from a gateway until SIGINT, -w writes the generated or replayed stream as one, and
+ * -i replays one. Without -w or -b the raw stream goes to out (a file, FIFO, or pty ingestd reads),
+ * stdout by default. -x paces it at that many times real time; the default, 0, is as fast as it goes.
+ *
+ * The benchmark feeds the stream through a pipe and stores every record in -D (a temporary file by
+ * default). It reports records per second over the whole run and over its slowest second, the
+ * ingest-to-queryable latency from the bytes being read to ts_append() returning (queries see a point
+ * from then on), and the peak resident memory, which includes the store's mapped pages.
+ *
+ * usage: loadgen [-n nodes] [-p report period s] [-d duration s] [-B baud] [-g outage s] [-G outage every s]
+ *                [-c corrupt fraction] [-u duplicate fraction] [-S seed] [-i capture | -R port]
+ *                [-x speed] [-w capture] [-b] [-D store.ts] [out]
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/resource.h>
+#include "../fec.h"
+#include "../packet.h"
+#include "serial.h"
+#include "ingest.h"
+#include "tsdb.h"
+
+#define LG_MAGIC            "TRAILCAP"
+#define LG_MAX_NODES        254
+#define LG_MAX_CHUNK        (1ul << 20)     // Largest chunk a capture may hold
+#define LG_ENERGY_EVERY     6               // Reports between energy summaries, as in main.c
+#define LG_DEPTH_EVERY      4               // Reports between depth readings
+#define LG_JITTER           0.1             // Report periods vary this much either way
+#define LG_OUT_BUF          65536           // Raw output is written in pieces this big
+#define LG_HIST_SUB         8               // Latency histogram buckets per doubling
+#define LG_HIST             (32 * LG_HIST_SUB)  // 1 us up to over an hour
+#define LG_TICK_NS          100000000       // Benchmark's look at the pipeline
+
+typedef struct LG_ChunkHeaderStruct{
+    double time;                        // Seconds since the epoch
+    uint32_t len;
+    uint32_t pad;
+} LG_ChunkHeader;
+
+typedef struct LG_NodeStruct{
+    double next;                        // Next report
+    double offset;                      // C warmer or colder than the trail's average
+    double depth;                       // mm
+    uint32_t charge;                    // uAh used
+    uint32_t reports;
+    uint8_t level;                      // FEC level it sends at
+    uint8_t seq;                        // Next report's sequence number
+    uint8_t booted;                     // Boot report has gone
+} LG_Node;
+
+typedef struct LG_GenStruct{
+    LG_Node nodes[LG_MAX_NODES];
+    int n;
+    double end, period, baud;
+    double outage, every;               // s, 0 for no outages
+    double corrupt, dup;                // Fractions of frames
+    uint64_t rng;
+    double line;                        // When the serial line is free again
+    uint8_t again[SER_MAX_FRAME];       // A duplicate still to send
+    int nagain;
+    uint8_t bounds;                     // Node that still has to send its bounds, 0 for none
+    // Counts
+    uint64_t frames, readings, air_hits, serial_hits, cut, duplicates, held;
+} LG_Gen;
+
+typedef enum LG_KindEnum{
+    LG_GENERATE,
+    LG_REPLAY,
+    LG_RECORD
+} LG_Kind;
+
+typedef struct LG_SourceStruct{
+    LG_Kind kind;
+    LG_Gen gen;
+    FILE *capture;
+    int port;
+} LG_Source;
+
+typedef struct LG_OutStruct{
+    int fd;                             // Raw stream, -1 for none
+    FILE *capture;                      // NULL for none
+    double speed;                       // Times real time, 0 for unpaced
+    double t0, wall0;                   // First chunk and when it went out
+    uint8_t buf[LG_OUT_BUF];
+    size_t len;
+    uint64_t bytes;
+} LG_Out;
+
+typedef struct LG_BenchStruct{
+    TS_DB *db;
+    uint64_t hist[LG_HIST];             // Ingest-to-queryable latencies, see lg_bucket()
+    uint64_t rejected;                  // Points the store wouldn't take
+    LG_Source *src;
+    LG_Out *out;
+    atomic_int fed;                     // The whole stream is in the pipe
+    int err;
+} LG_Bench;
+
+static volatile sig_atomic_t quit = 0;
+
+static void on_signal(int sig){
+    (void)sig;
+    quit = 1;
+}
+
+static double lg_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t lg_rand(uint64_t *state){
+    uint64_t x = (*state += 0x9E3779B97F4A7C15ull);     // splitmix64
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static double lg_unit(uint64_t *state){
+    return (lg_rand(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*
+ * Generator
+ */
+static void lg_gen_init(LG_Gen *g, int nodes, double start, double seconds, double period, uint64_t seed){
+    LG_Node *n;
+    int i;
+    memset(g, 0, sizeof(*g));
+    g->n = nodes;
+    g->end = start + seconds;
+    g->period = period;
+    g->rng = seed;
+    g->line = start;
+    for(i=0; i<nodes; i++){
+        n = &g->nodes[i];
+        n->next = start + lg_unit(&g->rng) * period;    // Nodes boot spread over a period
+        n->offset = (lg_unit(&g->rng) - 0.5) * 6;
+        n->depth = 300 + lg_unit(&g->rng) * 500;
+        n->level = lg_rand(&g->rng) % FEC_LEVELS;
+    }
+}
+
+/*
+ * Builds a node's next report as main.c would, at time t
+ */
+static void lg_report(LG_Gen *g, int i, double t, PKT_Frame *pkt){
+    LG_Node *n = &g->nodes[i];
+    uint8_t summary[PKT_ENERGY_SIZE];
+    double temp;
+    uint32_t depth_period = (uint32_t)g->period * LG_DEPTH_EVERY;
+
+    pkt_report_init(pkt, i + 1, fec_capacity(n->level));
+    temp = -6 + 5 * sin(2 * M_PI * (fmod(t, 86400) / 86400 - 0.375)) + n->offset + lg_unit(&g->rng) - 0.5;
+    pkt_report_add(pkt, PKT_SEN_TEMP, (int16_t)lround(temp));
+    pkt_report_add(pkt, PKT_SEN_PERIOD | PKT_SEN_TEMP, (int16_t)g->period);
+    if(n->reports % LG_DEPTH_EVERY == 0){
+        if(lg_unit(&g->rng) < 0.2){
+            n->depth += lg_unit(&g->rng) * 40;          // Snowing
+        }
+        pkt_report_add(pkt, PKT_SEN_DEPTH, (int16_t)lround(n->depth));
+        pkt_report_add(pkt, PKT_SEN_PERIOD | PKT_SEN_DEPTH, (int16_t)depth_period);
+    }
+    n->charge += 2 + lg_rand(&g->rng) % 3;
+    if(++n->reports % LG_ENERGY_EVERY == 0){
+        summary[0] = n->charge & 0xFF;
+        summary[1] = (n->charge >> 8) & 0xFF;
+        summary[2] = (n->charge >> 16) & 0xFF;
+        summary[3] = (n->charge >> 24) & 0xFF;
+        summary[4] = 0;                 // Sleeping uses the most
+        summary[5] = 60;
+        pkt_report_energy(pkt, summary);    // Doesn't fit at the highest level, the same on a node
+    }
+}
+
+static void lg_bounds(LG_Gen *g, int i, PKT_Frame *pkt){
+    pkt_report_init(pkt, i + 1, fec_capacity(g->nodes[i].level));
+    pkt_report_add(pkt, PKT_SEN_MIN | PKT_SEN_TEMP, 300);
+    pkt_report_add(pkt, PKT_SEN_MAX | PKT_SEN_TEMP, 3600);
+    pkt_report_add(pkt, PKT_SEN_MIN | PKT_SEN_DEPTH, 600);
+    pkt_report_add(pkt, PKT_SEN_MAX | PKT_SEN_DEPTH, 14400);
+}
+
+/*
+ * Numbers a report as seq.c does
+ */
+static void lg_stamp(LG_Node *n, PKT_Frame *pkt){
+    if(!n->booted){
+        pkt->buf[1] |= PKT_F_BOOT;
+        n->booted = 1;
+    }
+    pkt_set_seq(pkt, n->seq++);
+}
+
+/*
+ * When a frame heard at t reaches the base station: after an outage it's in, and after everything
+ * already on the serial line
+ */
+static double lg_line(LG_Gen *g, double t, int len){
+    double k;
+    if(g->every > 0){
+        k = floor(t / g->every) * g->every;
+        if(t < k + g->outage){
+            t = k + g->outage;
+            g->held++;
+        }
+    }
+    if(t < g->line){
+        t = g->line;
+    }
+    g->line = t + len * 10.0 / g->baud;
+    return t;
+}
+
+/*
+ * Damages a frame on its way in. Returns the serial frame's length, which may be cut short.
+ */
+static int lg_damage(LG_Gen *g, uint8_t level, uint8_t *air, uint8_t *out){
+    double kind = lg_unit(&g->rng);
+    int hits, len;
+    if(kind < 0.5){
+        hits = 1 + lg_rand(&g->rng) % (FEC_NSYM(level) / 2 + 2);    // Up to 2 more than it corrects
+        while(hits-- > 0){
+            air[lg_rand(&g->rng) % FEC_FRAME_SIZE] ^= 1 + lg_rand(&g->rng) % 255;
+        }
+        g->air_hits++;
+        return ser_frame(air, FEC_FRAME_SIZE, out);
+    }
+    len = ser_frame(air, FEC_FRAME_SIZE, out);
+    if(kind < 0.85){
+        out[lg_rand(&g->rng) % len] ^= 1 + lg_rand(&g->rng) % 255;
+        g->serial_hits++;
+        return len;
+    }
+    g->cut++;
+    return 1 + lg_rand(&g->rng) % (len - 1);
+}
+
+/*
+ * Next serial frame of the generated stream. Returns 1 once it has all been sent.
+ */
+static int lg_gen_next(LG_Gen *g, double *t, uint8_t *out, size_t *len){
+    PKT_Frame pkt;
+    uint8_t air[FEC_FRAME_SIZE];
+    int i, best = -1, n;
+
+    if(g->nagain > 0){
+        memcpy(out, g->again, g->nagain);
+        *len = g->nagain;
+        *t = lg_line(g, g->line, g->nagain);
+        g->nagain = 0;
+        g->duplicates++;
+        return 0;
+    }
+    if(g->bounds){
+        i = g->bounds - 1;
+        g->bounds = 0;
+        lg_bounds(g, i, &pkt);
+        *t = g->line;
+    }
+    else{
+        for(i=0; i<g->n; i++){
+            if(best < 0 || g->nodes[i].next < g->nodes[best].next){
+                best = i;
+            }
+        }
+        if(best < 0 || g->nodes[best].next >= g->end){
+            return 1;
+        }
+        i = best;
+        *t = g->nodes[i].next;
+        if(g->nodes[i].reports == 0){
+            g->bounds = i + 1;          // Sent right after the first report
+        }
+        lg_report(g, i, *t, &pkt);
+        g->nodes[i].next += g->period * (1 + LG_JITTER * (2 * lg_unit(&g->rng) - 1));
+    }
+    lg_stamp(&g->nodes[i], &pkt);
+    fec_encode(g->nodes[i].level, pkt.buf, pkt.len, air);
+    g->frames++;
+    g->readings += pkt.buf[PKT_HDR_SIZE];
+    if(lg_unit(&g->rng) < g->corrupt){
+        n = lg_damage(g, g->nodes[i].level, air, out);
+    }
+    else{
+        n = ser_frame(air, FEC_FRAME_SIZE, out);
+    }
+    *len = n;
+    *t = lg_line(g, *t, n);
+    if(lg_unit(&g->rng) < g->dup){
+        memcpy(g->again, out, n);
+        g->nagain = n;
+    }
+    return 0;
+}
+
+/*
+ * Sources. Each returns the next chunk of bytes and when it reached the base station, 1 at the end,
+ * or -1 on an error.
+ */
+static int lg_next(LG_Source *s, double *t, uint8_t *buf, size_t *len){
+    LG_ChunkHeader h;
+    struct pollfd pfd;
+    ssize_t n;
+
+    switch(s->kind){
+        case LG_GENERATE:
+            return lg_gen_next(&s->gen, t, buf, len);
+        case LG_REPLAY:
+            if(fread(&h, sizeof(h), 1, s->capture) != 1){
+                return ferror(s->capture) ? -1 : 1;
+            }
+            if(h.len > LG_MAX_CHUNK || fread(buf, 1, h.len, s->capture) != h.len){
+                return -1;
+            }
+            *t = h.time;
+            *len = h.len;
+            return 0;
+        case LG_RECORD:
+            pfd = (struct pollfd){s->port, POLLIN, 0};
+            while(!quit){
+                if(poll(&pfd, 1, 200) <= 0){
+                    continue;           // Quiet line, or a signal
+                }
+                n = read(s->port, buf, ING_CHUNK_SIZE);
+                if(n < 0 && errno == EINTR){
+                    continue;
+                }
+                if(n <= 0){
+                    return (n == 0) ? 1 : -1;
+                }
+                *t = lg_now();
+                *len = n;
+                return 0;
+            }
+            return 1;
+    }
+    return -1;
+}
+
+/*
+ * Output
+ */
+static int lg_write_all(int fd, const uint8_t *buf, size_t len){
+    ssize_t n;
+    while(len > 0){
+        n = write(fd, buf, len);
+        if(n < 0 && errno == EINTR){
+            continue;
+        }
+        if(n <= 0){
+            return -1;
+        }
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static int lg_flush(LG_Out *o){
+    if(o->len > 0 && lg_write_all(o->fd, o->buf, o->len) != 0){
+        return -1;
+    }
+    o->len = 0;
+    return 0;
+}
+
+/*
+ * Sends a chunk at its time over the speed, counted from the first chunk
+ */
+static int lg_put(LG_Out *o, double t, const uint8_t *buf, size_t len){
+    LG_ChunkHeader h = {t, (uint32_t)len, 0};
+    struct timespec ts;
+    double wait;
+
+    if(o->capture != NULL){
+        if(fwrite(&h, sizeof(h), 1, o->capture) != 1 || fwrite(buf, 1, len, o->capture) != len){
+            return -1;
+        }
+    }
+    if(o->fd < 0){
+        o->bytes += len;
+        return 0;
+    }
+    if(o->bytes == 0 && o->len == 0){
+        o->t0 = t;
+        o->wall0 = lg_now();
+    }
+    if(o->speed > 0 && (wait = o->wall0 + (t - o->t0) / o->speed - lg_now()) > 0){
+        if(lg_flush(o) != 0){           // Everything due so far goes out before the wait
+            return -1;
+        }
+        ts.tv_sec = (time_t)wait;
+        ts.tv_nsec = (long)((wait - ts.tv_sec) * 1e9);
+        nanosleep(&ts, NULL);
+    }
+    if(o->len + len > LG_OUT_BUF && lg_flush(o) != 0){
+        return -1;
+    }
+    if(len > LG_OUT_BUF){
+        return lg_write_all(o->fd, buf, len);
+    }
+    memcpy(&o->buf[o->len], buf, len);
+    o->len += len;
+    o->bytes += len;
+    return 0;
+}
+
+/*
+ * Copies the source to the output until it ends. Returns -1 on an error.
+ */
+static int lg_run(LG_Source *s, LG_Out *o){
+    static uint8_t buf[LG_MAX_CHUNK];
+    size_t len;
+    double t;
+    int r;
+    while(!quit && (r = lg_next(s, &t, buf, &len)) == 0){
+        if(lg_put(o, t, buf, len) != 0){
+            return -1;
+        }
+    }
+    if(o->fd >= 0 && lg_flush(o) != 0){
+        return -1;
+    }
+    return (quit || r == 1) ? 0 : -1;
+}
+
+/*
+ * Benchmark
+ */
+static int lg_bucket(double seconds){
+    double us = seconds * 1e6;
+    int b;
+    if(us < 1){
+        return 0;
+    }
+    b = (int)(log2(us) * LG_HIST_SUB) + 1;
+    return (b < LG_HIST) ? b : LG_HIST - 1;
+}
+
+// Upper edge of a bucket in seconds
+static double lg_bucket_top(int b){
+    return exp2((double)b / LG_HIST_SUB) * 1e-6;
+}
+
+static double lg_percentile(const LG_Bench *b, double p){
+    uint64_t total = 0, seen = 0;
+    int i;
+    for(i=0; i<LG_HIST; i++){
+        total += b->hist[i];
+    }
+    for(i=0; i<LG_HIST && total > 0; i++){
+        seen += b->hist[i];
+        if(seen >= p * total){
+            return lg_bucket_top(i);
+        }
+    }
+    return 0;
+}
+
+/*
+ * Stores a batch and times each record from its bytes being read to the store having it
+ */
+static int lg_sink(void *ctx, const ING_Record *records, size_t n){
+    LG_Bench *b = ctx;
+    double now;
+    size_t i;
+    for(i=0; i<n; i++){
+        if(ts_append(b->db, records[i].node, records[i].sensor, records[i].time, records[i].value) != 0){
+            b->rejected++;
+        }
+    }
+    now = lg_now();
+    for(i=0; i<n; i++){
+        b->hist[lg_bucket(now - records[i].time)]++;
+    }
+    return 0;
+}
+
+static void *lg_feed(void *arg){
+    LG_Bench *b = arg;
+    b->err = lg_run(b->src, b->out);
+    close(b->out->fd);                  // The pipeline drains and stops at the end of the pipe
+    atomic_store(&b->fed, 1);
+    return NULL;
+}
+
+static int lg_bench(LG_Source *s, LG_Out *o, const char *store){
+    static ING_Pipeline pipe_;
+    static TS_DB db;
+    static LG_Bench b;
+    char tmp[] = "/tmp/loadgenXXXXXX";
+    struct timespec tick = {0, LG_TICK_NS};
+    struct rusage ru;
+    pthread_t feeder;
+    ING_Stats st;
+    uint64_t last = 0;
+    double start, mark, now, rate, slowest = -1;
+    int fds[2], fd, err;
+
+    if(store == NULL){
+        if((fd = mkstemp(tmp)) < 0){
+            return -1;
+        }
+        close(fd);
+        store = tmp;
+    }
+    if(ts_open(&db, store, 1) != 0){
+        fprintf(stderr, "can't open a store at %s\n", store);
+        return -1;
+    }
+    if(pipe(fds) != 0){
+        return -1;
+    }
+    b.db = &db;
+    b.src = s;
+    b.out = o;
+    o->fd = fds[1];
+    atomic_init(&b.fed, 0);
+    start = mark = lg_now();
+    if(ingest_start(&pipe_, fds[0], -1, lg_sink, &b) != 0 || pthread_create(&feeder, NULL, lg_feed, &b) != 0){
+        fprintf(stderr, "can't start the pipeline\n");
+        return -1;
+    }
+    while(!ingest_done(&pipe_)){
+        nanosleep(&tick, NULL);
+        now = lg_now();
+        if(now - mark >= 1 && !atomic_load(&b.fed)){    // Only whole seconds with load on
+            ingest_stats(&pipe_, &st);
+            rate = (st.records - last) / (now - mark);
+            if(slowest < 0 || rate < slowest){
+                slowest = rate;
+            }
+            last = st.records;
+            mark = now;
+        }
+    }
+    now = lg_now();
+    pthread_join(feeder, NULL);
+    ingest_stats(&pipe_, &st);
+    err = ingest_join(&pipe_);
+    close(fds[0]);
+    getrusage(RUSAGE_SELF, &ru);
+
+    fprintf(stderr, "%llu records in %.2f s, %.0f records/s", (unsigned long long)st.records, now - start,
+            st.records / (now - start));
+    if(slowest >= 0){
+        fprintf(stderr, ", slowest second %.0f records/s", slowest);
+    }
+    fprintf(stderr, "\ningest to queryable: p50 %.3f ms, p99 %.3f ms, p99.9 %.3f ms\n",
+            lg_percentile(&b, 0.5) * 1e3, lg_percentile(&b, 0.99) * 1e3, lg_percentile(&b, 0.999) * 1e3);
+    fprintf(stderr, "peak memory %.1f MB, high water %zu/%d chunks %zu/%d records, waits %llu chunk %llu record\n",
+            ru.ru_maxrss / 1024.0, st.chunk_high, ING_CHUNKS, st.record_high, ING_RECORDS,
+            (unsigned long long)st.chunk_waits, (unsigned long long)st.record_waits);
+    fprintf(stderr, "%llu bytes, %llu frames (%llu bad CRC, %llu bytes skipped), %llu FEC failures, "
+            "%llu bytes corrected, %llu reports (%llu duplicates, %llu missing), %llu rejected by the store\n",
+            (unsigned long long)st.bytes, (unsigned long long)st.frames, (unsigned long long)st.bad_crc,
+            (unsigned long long)st.skipped, (unsigned long long)st.fec_failed, (unsigned long long)st.corrected,
+            (unsigned long long)st.reports, (unsigned long long)st.duplicates, (unsigned long long)st.gaps,
+            (unsigned long long)b.rejected);
+    ts_close(&db);
+    if(store == tmp){
+        unlink(tmp);
+    }
+    return (err || b.err) ? -1 : 0;
+}
+
+static void usage(const char *prog){
+    fprintf(stderr, "usage: %s [-n nodes] [-p report period s] [-d duration s] [-B baud] [-g outage s] [-G outage every s] "
+            "[-c corrupt fraction] [-u duplicate fraction] [-S seed] [-i capture | -R port] [-x speed] [-w capture] "
+            "[-b] [-D store.ts] [out]\n", prog);
+}
+
+int main(int argc, char **argv){
+    static LG_Source src;
+    static LG_Out out;
+    const char *replay = NULL, *port = NULL, *capture = NULL, *store = NULL;
+    double seconds = 86400, period = 600, baud = 115200, outage = 0, every = 0, corrupt = 0, dup = 0;
+    double speed = 0;
+    unsigned long long seed = 1;
+    int nodes = 50, bench = 0, opt, err;
+    LG_Gen *g = &src.gen;
+
+    while((opt = getopt(argc, argv, "n:p:d:B:g:G:c:u:S:i:R:x:w:bD:")) != -1){
+        switch(opt){
+            case 'n': nodes = atoi(optarg); break;
+            case 'p': period = atof(optarg); break;
+            case 'd': seconds = atof(optarg); break;
+            case 'B': baud = atof(optarg); break;
+            case 'g': outage = atof(optarg); break;
+            case 'G': every = atof(optarg); break;
+            case 'c': corrupt = atof(optarg); break;
+            case 'u': dup = atof(optarg); break;
+            case 'S': seed = strtoull(optarg, NULL, 0); break;
+            case 'i': replay = optarg; break;
+            case 'R': port = optarg; break;
+            case 'x': speed = atof(optarg); break;
+            case 'w': capture = optarg; break;
+            case 'b': bench = 1; break;
+            case 'D': store = optarg; break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if(argc - optind > 1 || nodes < 1 || nodes > LG_MAX_NODES || period <= 0 || baud <= 0 || speed < 0
+       || (every > 0 && outage >= every) || (replay != NULL && port != NULL) || (bench && port != NULL)){
+        usage(argv[0]);
+        return 2;
+    }
+
+    if(replay != NULL){
+        char magic[sizeof(LG_MAGIC) - 1];
+        src.kind = LG_REPLAY;
+        if((src.capture = fopen(replay, "rb")) == NULL || fread(magic, sizeof(magic), 1, src.capture) != 1
+           || memcmp(magic, LG_MAGIC, sizeof(magic)) != 0){
+            fprintf(stderr, "%s isn't a capture\n", replay);
+            return 1;
+        }
+    }
+    else if(port != NULL){
+        src.kind = LG_RECORD;
+        if((src.port = ser_open(port, (long)baud)) < 0){
+            fprintf(stderr, "can't open %s at %.0f baud\n", port, baud);
+            return 1;
+        }
+    }
+    else{
+        src.kind = LG_GENERATE;
+        lg_gen_init(g, nodes, floor(lg_now()), seconds, period, seed);
+        g->baud = baud;
+        g->outage = outage;
+        g->every = every;
+        g->corrupt = corrupt;
+        g->dup = dup;
+    }
+
+    out.speed = speed;
+    out.fd = -1;
+    if(capture != NULL){
+        if((out.capture = fopen(capture, "wb")) == NULL || fwrite(LG_MAGIC, sizeof(LG_MAGIC) - 1, 1, out.capture) != 1){
+            fprintf(stderr, "can't write %s\n", capture);
+            return 1;
+        }
+    }
+    else if(!bench){
+        out.fd = (optind == argc || strcmp(argv[optind], "-") == 0) ? STDOUT_FILENO
+                 : open(argv[optind], O_WRONLY | O_CREAT | O_TRUNC | O_NOCTTY, 0644);
+        if(out.fd < 0){
+            fprintf(stderr, "can't open %s\n", argv[optind]);
+            return 1;
+        }
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);           // A reader going away shows up as a failed write
+    err = bench ? lg_bench(&src, &out, store) : lg_run(&src, &out);
+    if(src.kind == LG_GENERATE){
+        fprintf(stderr, "generated %llu frames with %llu readings, %llu duplicates, %llu held by outages, "
+                "damaged %llu on the air %llu on the serial line %llu cut short\n",
+                (unsigned long long)g->frames, (unsigned long long)g->readings, (unsigned long long)g->duplicates,
+                (unsigned long long)g->held, (unsigned long long)g->air_hits, (unsigned long long)g->serial_hits,
+                (unsigned long long)g->cut);
+    }
+    if(out.capture != NULL && fclose(out.capture) != 0){
+        err = -1;
+    }
+    if(err){
+        fprintf(stderr, "stopped on an error\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,1065 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Discrete event simulator for a network of nodes around one gateway. Every node runs the real node
+ * firmware (main.c and the drivers under it) built into simnode.so against a virtual G2553 and nRF24
+ * (sim/vm.h). One copy of the library is loaded per node, so each has its own globals.
+ *
+ * Time goes forward in windows. In a window every node runs on its own until it reaches the end of the
+ * window or its receiver needs to know what was on the air, and the nodes are spread over the worker
+ * threads. Between runs the frames they sent are put on a shared medium and resolved, in order of
+ * when they ended, up to the earliest time a node could still start a frame. The result doesn't
+ * depend on the number of threads.
+ *
+ * The medium is log-distance path loss with per-link shadowing and per-frame fading, and a BER from
+ * the SINR of every byte, so frames that overlap interfere with each other. A bit error in the
+ * preamble or address loses the frame; errors in the payload are left for the FEC. The gateway decodes
+ * the uplinks the way the base station does (fec_decode.c, link.c, gap.c, energy.c), sends back FEC
+ * level changes and requests for missing reports, and can't receive while it sends.
+ *
+ * Sensor inputs come from a readings CSV as written by ingestd -o (time,node,sensor,value), replayed
+ * from its first reading with nodes not in the file mapped onto those that are, or from a synthetic
+ * diurnal temperature and a snow depth with a storm every few days. Nodes power up at random times in
+ * the first few minutes so they don't all report in step.
+ *
+ * Reports the delivery ratio, how many reports were missed for good once resends had their chance,
+ * latency from the first reading in a frame to its arrival, downlinks, and the energy each node drew
+ * on the virtual hardware against what its firmware estimated.
+ *
+ * usage: netsim [-n nodes] [-d days] [-b boot spread s] [-j threads] [-w window s] [-r radius m]
+ *               [-p positions] [-i readings.csv] [-x path loss exponent] [-s shadowing dB] [-f fading dB]
+ *               [-l extra loss] [-B gateway baud] [-t turnaround us] [-S seed] [-o nodes.csv] [-L simnode.so]
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include "../fec.h"
+#include "../packet.h"
+#include "sim/vm.h"
+#include "fec_decode.h"
+#include "link.h"
+#include "gap.h"
+#include "serial.h"
+#include "energy.h"
+
+#define SIM_MAX_NODES       254
+#define SIM_GATEWAY         (-1)
+#define SIM_AIRTIME         (((1 + 5 + VM_FRAME_SIZE) * 8 + 9) * (VM_HZ / 2000000))   // Same as nrf24.c
+#define SIM_BYTE            (8 * (VM_HZ / 2000000))
+#define SIM_HEADER_BYTES    6           // Preamble and address, an error here loses the frame
+#define SIM_LEAD            VM_US(130)  // A node can't put a frame on the air sooner than this
+#define SIM_PTX_DBM         0.0
+#define SIM_PL0_DB          40.05       // Free space at 1 m, 2.4 GHz
+#define SIM_NOISE_DBM       (-101.0)    // 2 MHz wide, 10 dB noise figure
+#define SIM_SENS_DBM        (-82.0)     // 2 Mbps, BER 1e-3
+#define SIM_PARALLEL        4           // Nodes per thread before using the pool
+
+typedef struct SimNodeStruct{
+    void *lib;
+    VM_Node *vm;
+    VM_ResumeFn resume;
+    const uint8_t *fec_level;           // The firmware's, NULL if not found
+    double x, y;                        // m from the gateway
+    uint64_t sent;
+    uint64_t delivered;
+    uint64_t lost_busy;                 // Gateway was sending
+    uint64_t lost_collision;            // Lost while overlapping another frame
+    uint64_t lost_weak;                 // Lost on its own
+    uint64_t corrected;                 // Bytes fixed by the FEC
+    uint64_t readings;
+    uint64_t downlinks;
+    uint64_t heard;                     // Downlinks for the node that made it into its inbox
+    uint64_t inbox_full;
+    uint64_t resent;                    // Uplinks that were answers to a PKT_CMD_RESEND
+    uint32_t charge_uah;                // From the last energy summary
+    uint8_t reported;
+} SimNode;
+
+typedef struct SimTxStruct{
+    VM_Frame f;
+    int from;                           // Node index or SIM_GATEWAY
+    uint64_t serial;                    // Order it was put on the medium, for ties
+    uint8_t resolved;
+} SimTx;
+
+typedef struct SimSeriesStruct{
+    double *t, *v;
+    size_t n, cap;
+} SimSeries;
+
+typedef struct SimEnvStruct{
+    uint64_t seed;
+    double t0;                          // First time in the file
+    uint16_t nfile;
+    uint8_t file_nodes[256];
+    SimSeries series[256][3];           // By node and sensor (temperature and depth)
+} SimEnv;
+
+typedef struct SimPoolStruct{
+    pthread_t *threads;
+    int nthreads;
+    pthread_mutex_t lock;
+    pthread_cond_t go, done;
+    uint64_t gen;                       // Bumped for every batch
+    int busy;                           // Workers still on the batch
+    int quit;
+    SimNode *nodes;
+    const uint16_t *list;
+    uint32_t nlist;
+    uint32_t next;                      // Next entry of list to run, atomic
+} SimPool;
+
+typedef struct SimStruct{
+    SimNode nodes[SIM_MAX_NODES];
+    uint16_t n;
+    double exponent, shadow, fade, loss;
+    double baud;                        // Gateway's UART to the base station
+    VM_Time turnaround;                 // Base station's time to decode a frame and answer
+    VM_Time uart_free;                  // UART down to the gateway is free from here
+    uint64_t seed;
+    SimTx *air;                         // Frames that may still matter, by start time
+    size_t nair, cap;
+    uint64_t serial;
+    VM_Time gw_free;                    // Gateway's transmitter is free from here
+    LINK_Table links;
+    GAP_Table gaps;
+    EN_Table energy;
+    float *latency;                     // Seconds
+    size_t nlatency, caplatency;
+    uint64_t downlinks;
+    uint64_t fec_changes;
+    uint64_t resend_requests;
+    uint64_t foreign;                   // Uplinks from a node heard by the gateway claiming another ID
+} Sim;
+
+/*
+ * Deterministic randomness, keyed so nothing depends on the order things run in
+ */
+static uint64_t sim_mix(uint64_t z){
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t sim_hash(uint64_t a, uint64_t b, uint64_t c){
+    return sim_mix(a ^ sim_mix(b ^ sim_mix(c)));
+}
+
+static double sim_unit(uint64_t h){
+    return (h >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double sim_gauss(uint64_t h){
+    double u = sim_unit(sim_mix(h)), v = sim_unit(sim_mix(h + 1));
+    return sqrt(-2.0 * log(u + 1e-300)) * cos(2.0 * M_PI * v);
+}
+
+/*
+ * Environment
+ */
+static int env_push(SimSeries *s, double t, double v){
+    double *nt, *nv;
+    size_t cap;
+    if(s->n == s->cap){
+        cap = s->cap ? s->cap * 2 : 256;
+        if((nt = realloc(s->t, cap * sizeof(double))) == NULL){
+            return -1;
+        }
+        s->t = nt;
+        if((nv = realloc(s->v, cap * sizeof(double))) == NULL){
+            return -1;
+        }
+        s->v = nv;
+        s->cap = cap;
+    }
+    s->t[s->n] = t;
+    s->v[s->n] = v;
+    s->n++;
+    return 0;
+}
+
+/*
+ * Loads temperature and depth readings from lines of time,node,sensor,value. Lines that don't parse
+ * (ex: a header) are skipped and readings are expected in time order per series.
+ */
+static int env_load(SimEnv *e, const char *path){
+    FILE *f = fopen(path, "r");
+    char line[128];
+    double t, v;
+    unsigned node, sensor;
+    uint8_t seen[256] = {0};
+    if(f == NULL){
+        return -1;
+    }
+    e->t0 = -1;
+    while(fgets(line, sizeof(line), f) != NULL){
+        if(sscanf(line, "%lf,%u,%u,%lf", &t, &node, &sensor, &v) != 4 || node > 255
+           || (sensor != PKT_SEN_TEMP && sensor != PKT_SEN_DEPTH)){
+            continue;
+        }
+        if(e->t0 < 0 || t < e->t0){
+            e->t0 = t;
+        }
+        if(!seen[node]){
+            seen[node] = 1;
+            e->file_nodes[e->nfile++] = node;
+        }
+        if(env_push(&e->series[node][sensor], t, v) != 0){
+            fclose(f);
+            return -1;
+        }
+    }
+    fclose(f);
+    return (e->nfile > 0) ? 0 : -1;
+}
+
+static double env_replay(const SimSeries *s, double t){
+    size_t lo = 0, hi = s->n - 1, mid;
+    if(t <= s->t[0]){
+        return s->v[0];
+    }
+    if(t >= s->t[hi]){
+        return s->v[hi];
+    }
+    while(hi - lo > 1){
+        mid = (lo + hi) / 2;
+        if(s->t[mid] <= t){
+            lo = mid;
+        }
+        else{
+            hi = mid;
+        }
+    }
+    return s->v[lo] + (s->v[hi] - s->v[lo]) * (t - s->t[lo]) / (s->t[hi] - s->t[lo]);
+}
+
+/*
+ * Made up weather: a daily cycle peaking mid afternoon on top of a slower one, and a storm every 3.5
+ * days dropping 150 mm over 10 h on a pack that settles 6 mm a day. Every node is offset a little.
+ */
+static double env_synthetic(const SimEnv *e, uint8_t node, uint8_t sensor, double seconds){
+    double day = seconds / 86400.0, offset = sim_gauss(sim_hash(e->seed, node, sensor)), depth, start, f;
+    int k;
+    if(sensor == PKT_SEN_TEMP){
+        return -4.0 + 6.0 * sin(2.0 * M_PI * (day - 0.375)) + 4.0 * sin(2.0 * M_PI * day / 5.0) + 1.5 * offset;
+    }
+    depth = 800.0 + 50.0 * offset - 6.0 * day;
+    for(k=0; (start = 1.0 + 3.5 * k) < day; k++){
+        f = (day - start) * 24.0 / 10.0;
+        depth += 150.0 * ((f < 1.0) ? f : 1.0);
+    }
+    return depth;
+}
+
+static double env_value(void *ctx, uint8_t node, uint8_t sensor, double seconds){
+    const SimEnv *e = ctx;
+    const SimSeries *s;
+    if(sensor != PKT_SEN_TEMP && sensor != PKT_SEN_DEPTH){
+        return 0;
+    }
+    if(e->nfile > 0){
+        s = &e->series[node][sensor];
+        if(s->n == 0){
+            s = &e->series[e->file_nodes[(node - 1) % e->nfile]][sensor];
+        }
+        if(s->n > 0){
+            return env_replay(s, e->t0 + seconds);
+        }
+    }
+    return env_synthetic(e, node, sensor, seconds);
+}
+
+/*
+ * Nodes
+ */
+static int sim_copy(const char *from, const char *to){
+    FILE *in = fopen(from, "rb"), *out;
+    char buf[65536];
+    size_t n;
+    int err = 0;
+    if(in == NULL){
+        return -1;
+    }
+    if((out = fopen(to, "wb")) == NULL){
+        fclose(in);
+        return -1;
+    }
+    while((n = fread(buf, 1, sizeof(buf), in)) > 0){
+        if(fwrite(buf, 1, n, out) != n){
+            err = -1;
+            break;
+        }
+    }
+    fclose(in);
+    return (fclose(out) != 0) ? -1 : err;
+}
+
+/*
+ * Loads its own copy of the node library for each node. dlopen() hands back the same copy for the
+ * same file, so each gets a file of its own, removed again as soon as it's mapped.
+ */
+static int sim_load(Sim *s, const char *so, SimEnv *env, double spread){
+    char dir[] = "/tmp/netsimXXXXXX", path[64];
+    VM_StartFn start;
+    SimNode *n;
+    uint16_t i;
+    int err = 0;
+
+    if(mkdtemp(dir) == NULL){
+        return -1;
+    }
+    for(i=0; i<s->n && err == 0; i++){
+        n = &s->nodes[i];
+        snprintf(path, sizeof(path), "%s/node%u.so", dir, i + 1);
+        if(sim_copy(so, path) != 0){
+            err = -1;
+        }
+        else if((n->lib = dlopen(path, RTLD_NOW | RTLD_LOCAL)) == NULL){
+            fprintf(stderr, "%s\n", dlerror());
+            err = -1;
+        }
+        unlink(path);
+        if(err){
+            break;
+        }
+        n->vm = dlsym(n->lib, "vm_node");
+        start = (VM_StartFn)dlsym(n->lib, "vm_start");
+        n->resume = (VM_ResumeFn)dlsym(n->lib, "vm_resume");
+        n->fec_level = dlsym(n->lib, "fec_level");
+        if(n->vm == NULL || start == NULL || n->resume == NULL){
+            fprintf(stderr, "%s isn't a node library\n", so);
+            err = -1;
+            break;
+        }
+        n->vm->id = i + 1;
+        n->vm->seed = sim_hash(s->seed, i + 1, 0x6E6F6465);
+        n->vm->boot = (VM_Time)(spread * sim_unit(sim_hash(s->seed, i + 1, 0x626F6F74)) * VM_HZ);
+        n->vm->env = env_value;
+        n->vm->env_ctx = env;
+        if(start() != 0){
+            err = -1;
+        }
+    }
+    rmdir(dir);
+    return err;
+}
+
+/*
+ * Places nodes from lines of "node x y" in m from the gateway, and the rest uniformly in a disc
+ */
+static int sim_place(Sim *s, const char *path, double radius){
+    char line[128];
+    double x, y, r, a;
+    unsigned node;
+    uint8_t placed[SIM_MAX_NODES] = {0};
+    uint16_t i;
+    FILE *f;
+
+    if(path != NULL){
+        if((f = fopen(path, "r")) == NULL){
+            return -1;
+        }
+        while(fgets(line, sizeof(line), f) != NULL){
+            if(sscanf(line, "%u %lf %lf", &node, &x, &y) == 3 && node >= 1 && node <= s->n){
+                s->nodes[node - 1].x = x;
+                s->nodes[node - 1].y = y;
+                placed[node - 1] = 1;
+            }
+        }
+        fclose(f);
+    }
+    for(i=0; i<s->n; i++){
+        if(!placed[i]){
+            r = radius * sqrt(sim_unit(sim_hash(s->seed, i + 1, 0x706F73)));
+            a = 2.0 * M_PI * sim_unit(sim_hash(s->seed, i + 1, 0x616E67));
+            s->nodes[i].x = r * cos(a);
+            s->nodes[i].y = r * sin(a);
+        }
+    }
+    return 0;
+}
+
+/*
+ * Worker threads, each running whichever node is next on the list
+ */
+static void pool_work(SimPool *p){
+    uint32_t i;
+    while((i = __atomic_fetch_add(&p->next, 1, __ATOMIC_RELAXED)) < p->nlist){
+        p->nodes[p->list[i]].resume();
+    }
+}
+
+static void *pool_main(void *arg){
+    SimPool *p = arg;
+    uint64_t seen = 0;
+    for(;;){
+        pthread_mutex_lock(&p->lock);
+        while(p->gen == seen && !p->quit){
+            pthread_cond_wait(&p->go, &p->lock);
+        }
+        if(p->quit){
+            pthread_mutex_unlock(&p->lock);
+            return NULL;
+        }
+        seen = p->gen;
+        pthread_mutex_unlock(&p->lock);
+        pool_work(p);
+        pthread_mutex_lock(&p->lock);
+        if(--p->busy == 0){
+            pthread_cond_signal(&p->done);
+        }
+        pthread_mutex_unlock(&p->lock);
+    }
+}
+
+static int pool_start(SimPool *p, SimNode *nodes, int nthreads){
+    int i;
+    memset(p, 0, sizeof(*p));
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->go, NULL);
+    pthread_cond_init(&p->done, NULL);
+    p->nodes = nodes;
+    p->nthreads = nthreads - 1;         // The main thread is the last one
+    if(p->nthreads > 0 && (p->threads = calloc(p->nthreads, sizeof(pthread_t))) == NULL){
+        return -1;
+    }
+    for(i=0; i<p->nthreads; i++){
+        if(pthread_create(&p->threads[i], NULL, pool_main, p) != 0){
+            p->nthreads = i;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void pool_run(SimPool *p, const uint16_t *list, uint32_t n){
+    p->list = list;
+    p->nlist = n;
+    p->next = 0;
+    if(p->nthreads == 0 || n < (uint32_t)SIM_PARALLEL * (p->nthreads + 1)){
+        pool_work(p);
+        return;
+    }
+    pthread_mutex_lock(&p->lock);
+    p->busy = p->nthreads;
+    p->gen++;
+    pthread_cond_broadcast(&p->go);
+    pthread_mutex_unlock(&p->lock);
+    pool_work(p);
+    pthread_mutex_lock(&p->lock);
+    while(p->busy > 0){
+        pthread_cond_wait(&p->done, &p->lock);
+    }
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void pool_stop(SimPool *p){
+    int i;
+    pthread_mutex_lock(&p->lock);
+    p->quit = 1;
+    pthread_cond_broadcast(&p->go);
+    pthread_mutex_unlock(&p->lock);
+    for(i=0; i<p->nthreads; i++){
+        pthread_join(p->threads[i], NULL);
+    }
+    free(p->threads);
+}
+
+/*
+ * Medium
+ */
+static int air_add(Sim *s, const VM_Frame *f, int from){
+    SimTx *air;
+    size_t i;
+    if(s->nair == s->cap){
+        s->cap = s->cap ? s->cap * 2 : 256;
+        if((air = realloc(s->air, s->cap * sizeof(SimTx))) == NULL){
+            return -1;
+        }
+        s->air = air;
+    }
+    for(i=s->nair; i>0 && s->air[i-1].f.start > f->start; i--){
+        s->air[i] = s->air[i-1];
+    }
+    s->air[i].f = *f;
+    s->air[i].from = from;
+    s->air[i].serial = s->serial++;
+    s->air[i].resolved = 0;
+    s->nair++;
+    return 0;
+}
+
+static void sim_where(const Sim *s, int who, double *x, double *y){
+    *x = (who == SIM_GATEWAY) ? 0.0 : s->nodes[who].x;
+    *y = (who == SIM_GATEWAY) ? 0.0 : s->nodes[who].y;
+}
+
+/*
+ * Received power in dBm of a frame from one radio at another
+ */
+static double sim_rx_dbm(const Sim *s, const SimTx *tx, int to){
+    double x0, y0, x1, y1, d;
+    uint64_t a = (uint64_t)(tx->from + 1), b = (uint64_t)(to + 1);
+    sim_where(s, tx->from, &x0, &y0);
+    sim_where(s, to, &x1, &y1);
+    d = hypot(x1 - x0, y1 - y0);
+    return SIM_PTX_DBM - SIM_PL0_DB - 10.0 * s->exponent * log10((d > 1.0) ? d : 1.0)
+           - s->shadow * sim_gauss(sim_hash(s->seed, (a < b) ? a : b, (a < b) ? b : a))
+           - s->fade * sim_gauss(sim_hash(s->seed ^ 0x66616465, tx->serial, b));
+}
+
+/*
+ * BER of the GFSK receiver at an SINR, put through the sensitivity point
+ */
+static double sim_ber(double sinr_db){
+    double ebn0 = pow(10.0, (sinr_db - (SIM_SENS_DBM - SIM_NOISE_DBM) + 10.94) / 10.0);
+    return 0.5 * exp(-ebn0 / 2.0);
+}
+
+/*
+ * Works out what one radio got of a frame, byte slot by byte slot. Returns 1 if it was detected and
+ * fills data with the payload as received, 0 if it was lost, with overlap set if anything else was
+ * on the air at the time.
+ */
+static int sim_receive(Sim *s, const SimTx *tx, int to, uint8_t *data, int *overlap){
+    double sig = sim_rx_dbm(s, tx, to), noise = pow(10.0, SIM_NOISE_DBM / 10.0), ber, in;
+    double imw[16];
+    VM_Time istart[16], iend[16], t0, t1;
+    uint64_t rng = sim_hash(s->seed ^ 0x62697473, tx->serial, to + 1);
+    int ni = 0, i, k, b;
+    size_t j;
+
+    *overlap = 0;
+    if(sim_unit(sim_mix(rng++)) < s->loss){
+        return 0;
+    }
+    for(j=0; j<s->nair && ni < 16; j++){
+        const SimTx *o = &s->air[j];
+        if(o == tx || o->from == to || o->f.start >= tx->f.end || o->f.end <= tx->f.start){
+            continue;
+        }
+        istart[ni] = o->f.start;
+        iend[ni] = o->f.end;
+        imw[ni++] = pow(10.0, sim_rx_dbm(s, o, to) / 10.0);
+    }
+    *overlap = ni > 0;
+    memcpy(data, tx->f.data, VM_FRAME_SIZE);
+    for(k=0; k<SIM_HEADER_BYTES + VM_FRAME_SIZE; k++){
+        t0 = tx->f.start + k * SIM_BYTE;
+        t1 = t0 + SIM_BYTE;
+        in = noise;
+        for(i=0; i<ni; i++){
+            if(istart[i] < t1 && iend[i] > t0){
+                in += imw[i];
+            }
+        }
+        ber = sim_ber(sig - 10.0 * log10(in));
+        if(ber < 1e-9){
+            continue;
+        }
+        for(b=0; b<8; b++){
+            if(sim_unit(sim_mix(rng++)) < ber){
+                if(k < SIM_HEADER_BYTES){
+                    return 0;
+                }
+                data[k - SIM_HEADER_BYTES] ^= 1 << b;
+            }
+        }
+    }
+    return 1;
+}
+
+static void sim_latency(Sim *s, double seconds){
+    float *l;
+    if(s->nlatency == s->caplatency){
+        s->caplatency = s->caplatency ? s->caplatency * 2 : 4096;
+        if((l = realloc(s->latency, s->caplatency * sizeof(float))) == NULL){
+            s->caplatency = s->nlatency;
+            return;
+        }
+        s->latency = l;
+    }
+    s->latency[s->nlatency++] = (float)seconds;
+}
+
+/*
+ * Gateway sends a node a control frame once the uplink has crossed the UART to the base station, the
+ * base station has answered, and the answer has crossed back behind any others already on the way
+ */
+static void sim_reply(Sim *s, const SimTx *tx, uint8_t node, uint8_t cmd, const uint8_t *args, uint8_t nargs){
+    PKT_Frame pkt;
+    VM_Frame f;
+    VM_Time uart = (VM_Time)((FEC_FRAME_SIZE + SER_OVERHEAD) * 10.0 / s->baud * VM_HZ);
+    f.start = tx->f.end + uart + s->turnaround;
+    if(f.start < s->uart_free){
+        f.start = s->uart_free;
+    }
+    f.start += uart;
+    s->uart_free = f.start;
+    if(f.start < s->gw_free){
+        f.start = s->gw_free;
+    }
+    f.end = f.start + SIM_AIRTIME;
+    f.sampled = VM_NEVER;
+    pkt_control_init(&pkt, node, cmd, args, nargs);
+    fec_encode(0, pkt.buf, pkt.len, f.data);
+    s->gw_free = f.end;
+    s->downlinks++;
+    if(node >= 1 && node <= s->n){
+        s->nodes[node - 1].downlinks++;
+    }
+    air_add(s, &f, SIM_GATEWAY);
+}
+
+/*
+ * Gateway decodes an uplink like the base station would
+ */
+static void sim_gateway(Sim *s, size_t at){
+    SimTx tx = s->air[at];              // air may move under sim_reply()
+    SimNode *n = &s->nodes[tx.from];
+    uint8_t data[VM_FRAME_SIZE], node, level, args[2];
+    FEC_Result res;
+    PKT_Report report;
+    int overlap, corrected, dedup;
+    double when = VM_SECONDS(tx.f.end);
+    size_t j;
+
+    for(j=0; j<s->nair; j++){
+        if(s->air[j].from == SIM_GATEWAY && s->air[j].f.start < tx.f.end && s->air[j].f.end > tx.f.start){
+            n->lost_busy++;
+            return;
+        }
+    }
+    if(!sim_receive(s, &s->air[at], SIM_GATEWAY, data, &overlap)){
+        if(overlap){
+            n->lost_collision++;
+        }
+        else{
+            n->lost_weak++;
+        }
+        return;
+    }
+    corrected = fec_decode(data, &res);
+    if(corrected < 0){
+        link_suspect(&s->links, data[1]);
+        if(overlap){
+            n->lost_collision++;
+        }
+        else{
+            n->lost_weak++;
+        }
+        return;
+    }
+    node = res.data[0];
+    if(link_update(&s->links, node, corrected)){
+        level = link_level(&s->links, node);
+        sim_reply(s, &tx, node, PKT_CMD_FEC, &level, 1);
+        s->fec_changes++;
+    }
+    n->delivered++;
+    n->corrected += corrected;
+    if(node != n->vm->id){
+        s->foreign++;
+    }
+    if(pkt_report_parse(res.data, res.len, &report) != 0){
+        return;
+    }
+    n->resent += (report.flags & PKT_F_RESENT) != 0;
+    if((dedup = gap_update(&s->gaps, node, report.seq, report.flags, when)) == GAP_DUPLICATE){
+        return;
+    }
+    if(!(report.flags & PKT_F_RESENT) && gap_request(&s->gaps, node, when, args) > 0){
+        sim_reply(s, &tx, node, PKT_CMD_RESEND, args, sizeof(args));
+        s->resend_requests++;
+    }
+    n->readings += report.count;
+    if(tx.f.sampled != VM_NEVER){
+        sim_latency(s, VM_SECONDS(tx.f.end - tx.f.sampled));
+    }
+    if((report.flags & PKT_F_ENERGY) && dedup == GAP_NEW){
+        n->charge_uah = report.charge_uah;
+        n->reported = 1;
+        energy_update(&s->energy, node, when, report.charge_uah, report.top_state, report.top_share);
+    }
+}
+
+/*
+ * Nodes that were listening for the whole frame get it in their inbox if they detected it
+ */
+static void sim_listeners(Sim *s, size_t at){
+    const SimTx *tx = &s->air[at];
+    VM_Node *vm;
+    uint8_t data[VM_FRAME_SIZE];
+    uint16_t i;
+    uint32_t k;
+    int overlap;
+
+    for(i=0; i<s->n; i++){
+        vm = s->nodes[i].vm;
+        if((int)i == tx->from || vm->status == VM_HALTED){
+            continue;
+        }
+        for(k=0; k<vm->nrx; k++){
+            if(vm->rx[k].start <= tx->f.start && vm->rx[k].end >= tx->f.end){
+                break;
+            }
+        }
+        if(k == vm->nrx || !sim_receive(s, tx, i, data, &overlap)){
+            continue;
+        }
+        if(vm->in_tail - vm->in_head == VM_INBOX){
+            s->nodes[i].inbox_full++;
+            continue;
+        }
+        if(tx->from == SIM_GATEWAY && tx->f.data[1] == vm->id){
+            s->nodes[i].heard++;
+        }
+        vm->inbox[vm->in_tail % VM_INBOX] = tx->f;
+        memcpy(vm->inbox[vm->in_tail % VM_INBOX].data, data, VM_FRAME_SIZE);
+        vm->in_tail++;
+    }
+}
+
+/*
+ * Resolves every frame that ends by h, in the order they end, then forgets frames that can't overlap
+ * anything still to come
+ */
+static void sim_resolve(Sim *s, VM_Time h){
+    size_t i, best, j;
+    for(;;){
+        best = s->nair;
+        for(i=0; i<s->nair; i++){
+            if(!s->air[i].resolved && s->air[i].f.end <= h
+               && (best == s->nair || s->air[i].f.end < s->air[best].f.end
+                   || (s->air[i].f.end == s->air[best].f.end && s->air[i].serial < s->air[best].serial))){
+                best = i;
+            }
+        }
+        if(best == s->nair){
+            break;
+        }
+        s->air[best].resolved = 1;
+        sim_listeners(s, best);
+        if(s->air[best].from != SIM_GATEWAY){
+            sim_gateway(s, best);
+        }
+    }
+    for(i=j=0; i<s->nair; i++){
+        if(!s->air[i].resolved || s->air[i].f.end + SIM_AIRTIME + VM_US(1000) > h){
+            s->air[j++] = s->air[i];
+        }
+    }
+    s->nair = j;
+}
+
+/*
+ * Runs every node to until, resolving the medium whenever they have all moved on
+ */
+static int sim_window(Sim *s, SimPool *pool, VM_Time until, uint16_t *list){
+    VM_Node *vm;
+    VM_Time h, t;
+    uint32_t n, k;
+    uint16_t i;
+    int done;
+
+    for(i=0; i<s->n; i++){
+        s->nodes[i].vm->until = until;
+    }
+    do{
+        for(i=n=0; i<s->n; i++){
+            vm = s->nodes[i].vm;
+            if((vm->status == VM_PAUSED && vm->now < until)
+               || (vm->status == VM_BLOCKED && vm->heard >= vm->now && vm->nout < VM_OUTBOX)){
+                list[n++] = i;
+            }
+        }
+        pool_run(pool, list, n);
+        h = VM_NEVER;
+        done = 1;
+        for(i=0; i<s->n; i++){
+            vm = s->nodes[i].vm;
+            for(k=0; k<vm->nout; k++){
+                if(air_add(s, &vm->outbox[k], i) != 0){
+                    return -1;
+                }
+                s->nodes[i].sent++;
+            }
+            vm->nout = 0;
+            if(vm->status != VM_HALTED){
+                t = vm->now + SIM_LEAD;
+                h = (t < h) ? t : h;
+                done &= vm->status == VM_PAUSED && vm->now >= until;
+            }
+        }
+        if(h == VM_NEVER){
+            h = until;
+        }
+        sim_resolve(s, h);
+        for(i=0; i<s->n; i++){
+            s->nodes[i].vm->heard = h;
+        }
+    } while(!done);
+    return 0;
+}
+
+/*
+ * Report
+ */
+static int cmp_float(const void *a, const void *b){
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+static int cmp_double(const void *a, const void *b){
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double sim_mah(const VM_Node *vm){
+    double uas = 0;
+    int i;
+    for(i=0; i<PWR_NUM_STATES; i++){
+        uas += VM_SECONDS(vm->spent[i]) * vm->ua[i];
+    }
+    return uas / 3600.0 / 1000.0;
+}
+
+static void sim_report(Sim *s, double seconds, double wall, FILE *csv){
+    uint64_t sent = 0, delivered = 0, busy = 0, collision = 0, weak = 0, readings = 0, accesses = 0;
+    uint64_t interrupts = 0, inbox_full = 0, rx_dropped = 0, resent = 0, downlinks = 0, heard = 0;
+    uint64_t reports = 0, duplicates = 0, gaps = 0, filled = 0;
+    double *ratio = malloc(s->n * sizeof(double)), *mah = malloc(s->n * sizeof(double));
+    double *projected = malloc(s->n * sizeof(double));
+    double hours = seconds / 3600.0, total_mah = 0, life, shortest;
+    uint16_t i, halted = 0, nprojected = 0, levels[FEC_LEVELS + 1] = {0};
+    uint8_t worst;
+    SimNode *n;
+    GAP_Node *g;
+
+    if(ratio == NULL || mah == NULL || projected == NULL){
+        free(ratio);
+        free(mah);
+        free(projected);
+        return;
+    }
+    if(csv != NULL){
+        fprintf(csv, "node,x,y,sent,delivered,lost_busy,lost_collision,lost_weak,corrected,readings,downlinks,resent,missing,filled,"
+                "mah,avg_ua,reported_mah,projected_h,top_state,fec_level,halt\n");
+    }
+    for(i=0; i<s->n; i++){
+        n = &s->nodes[i];
+        g = &s->gaps.nodes[n->vm->id];
+        sent += n->sent;
+        delivered += n->delivered;
+        busy += n->lost_busy;
+        collision += n->lost_collision;
+        weak += n->lost_weak;
+        readings += n->readings;
+        inbox_full += n->inbox_full;
+        downlinks += n->downlinks;
+        heard += n->heard;
+        accesses += n->vm->accesses;
+        interrupts += n->vm->interrupts;
+        rx_dropped += n->vm->rx_dropped;
+        resent += n->resent;
+        reports += g->reports;
+        duplicates += g->duplicates;
+        gaps += g->gaps;
+        filled += g->filled;
+        ratio[i] = n->sent ? (double)n->delivered / n->sent : 0;
+        mah[i] = sim_mah(n->vm);
+        total_mah += mah[i];
+        if(energy_life_hours(&s->energy, n->vm->id) >= 0){
+            projected[nprojected++] = energy_life_hours(&s->energy, n->vm->id);
+        }
+        halted += n->vm->status == VM_HALTED;
+        levels[(n->fec_level != NULL && *n->fec_level < FEC_LEVELS) ? *n->fec_level : FEC_LEVELS]++;
+        if(csv != NULL){
+            fprintf(csv, "%u,%.1f,%.1f,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%u,%u,%.4f,%.2f,", i + 1, n->x, n->y,
+                    (unsigned long long)n->sent, (unsigned long long)n->delivered, (unsigned long long)n->lost_busy,
+                    (unsigned long long)n->lost_collision, (unsigned long long)n->lost_weak,
+                    (unsigned long long)n->corrected, (unsigned long long)n->readings,
+                    (unsigned long long)n->downlinks, (unsigned long long)n->resent, g->gaps, g->filled,
+                    mah[i], mah[i] * 1000.0 / hours);
+            if(n->reported){
+                fprintf(csv, "%.4f", n->charge_uah / 1000.0);
+            }
+            fprintf(csv, ",");
+            if(energy_life_hours(&s->energy, n->vm->id) >= 0){
+                fprintf(csv, "%.0f,%s", energy_life_hours(&s->energy, n->vm->id),
+                        energy_state_name(s->energy.nodes[n->vm->id].top_state));
+            }
+            else{
+                fprintf(csv, ",");
+            }
+            fprintf(csv, ",%d,%s\n", (n->fec_level != NULL) ? *n->fec_level : -1,
+                    (n->vm->status == VM_HALTED) ? n->vm->halt : "");
+        }
+    }
+    qsort(ratio, s->n, sizeof(double), cmp_double);
+    qsort(mah, s->n, sizeof(double), cmp_double);
+    qsort(projected, nprojected, sizeof(double), cmp_double);
+    qsort(s->latency, s->nlatency, sizeof(float), cmp_float);
+
+    printf("%u nodes, %.2f days in %.1f s (%.0fx), %llu register accesses, %llu interrupts\n", s->n,
+           seconds / 86400.0, wall, seconds / wall, (unsigned long long)accesses, (unsigned long long)interrupts);
+    printf("uplinks: %llu sent, %llu delivered (%.2f%%), lost %llu to collisions, %llu weak, %llu gateway busy\n",
+           (unsigned long long)sent, (unsigned long long)delivered, sent ? 100.0 * delivered / sent : 0.0,
+           (unsigned long long)collision, (unsigned long long)weak, (unsigned long long)busy);
+    printf("delivery per node: min %.2f%% p10 %.2f%% median %.2f%%, %llu readings\n", 100.0 * ratio[0],
+           100.0 * ratio[s->n / 10], 100.0 * ratio[s->n / 2], (unsigned long long)readings);
+    printf("reports: %llu kept, %llu duplicates dropped, %llu missing, %llu filled (%llu resent uplinks), "
+           "%llu lost for good (%.2f%%)\n", (unsigned long long)reports, (unsigned long long)duplicates,
+           (unsigned long long)gaps, (unsigned long long)filled, (unsigned long long)resent,
+           (unsigned long long)(gaps - filled), (reports + gaps - filled) ? 100.0 * (gaps - filled) / (reports + gaps - filled) : 0.0);
+    if(s->nlatency > 0){
+        printf("latency, first reading to gateway: p50 %.1f ms p90 %.1f ms p99 %.1f ms max %.1f ms\n",
+               1000.0 * s->latency[s->nlatency / 2], 1000.0 * s->latency[s->nlatency * 9 / 10],
+               1000.0 * s->latency[s->nlatency * 99 / 100], 1000.0 * s->latency[s->nlatency - 1]);
+    }
+    printf("downlinks: %llu FEC changes and %llu resend requests sent, %llu of %llu heard by their node, "
+           "%llu frames lost to full inboxes, %llu to full RX FIFOs\n", (unsigned long long)s->fec_changes,
+           (unsigned long long)s->resend_requests, (unsigned long long)heard, (unsigned long long)downlinks,
+           (unsigned long long)inbox_full, (unsigned long long)rx_dropped);
+    printf("FEC level at the end:");
+    for(i=0; i<FEC_LEVELS; i++){
+        printf(" %u: %u", i, levels[i]);
+    }
+    printf("\n");
+    life = (mah[s->n / 2] > 0) ? EN_CAPACITY_MAH / (mah[s->n / 2] / hours) / (24.0 * 365.0) : 0;
+    printf("energy per node: min %.3f median %.3f max %.3f mAh, median %.1f uA average, %.1f years on %.0f mAh\n",
+           mah[0], mah[s->n / 2], mah[s->n - 1], mah[s->n / 2] * 1000.0 / hours, life, EN_CAPACITY_MAH);
+    if(energy_shortest(&s->energy, &worst, &shortest) > 0){     // What the base station works out from the summaries
+        printf("projected at the base station for %u nodes: median %.0f h (%.1f years), shortest node %u with %.0f h "
+               "at %.1f uA, mostly %s (%u%%)\n", nprojected, projected[nprojected / 2],
+               projected[nprojected / 2] / (24.0 * 365.0), worst, shortest, s->energy.nodes[worst].rate_uah_per_h,
+               energy_state_name(s->energy.nodes[worst].top_state), s->energy.nodes[worst].top_share);
+    }
+    if(halted > 0){
+        printf("%u nodes halted, see the node CSV\n", halted);
+    }
+    if(s->foreign > 0){
+        printf("%llu uplinks decoded with another node's ID\n", (unsigned long long)s->foreign);
+    }
+    free(ratio);
+    free(mah);
+    free(projected);
+}
+
+static void usage(const char *name){
+    fprintf(stderr, "usage: %s [-n nodes] [-d days] [-b boot spread s] [-j threads] [-w window s] [-r radius m] [-p positions] "
+            "[-i readings.csv] [-x path loss exponent] [-s shadowing dB] [-f fading dB] [-l extra loss] "
+            "[-B gateway baud] [-t turnaround us] [-S seed] [-o nodes.csv] [-L simnode.so]\n", name);
+}
+
+int main(int argc, char **argv){
+    static Sim s;
+    static SimEnv env;
+    SimPool pool;
+    const char *positions = NULL, *readings = NULL, *out = NULL, *slash;
+    char so[4096];
+    double days = 1.0, window = 60.0, radius = 80.0, spread = 600.0, wall;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN), nodes = 16;
+    uint16_t list[SIM_MAX_NODES];
+    struct timespec t0, t1;
+    VM_Time t, end;
+    FILE *csv = NULL;
+    int opt;
+
+    s.exponent = 2.2;
+    s.shadow = 4.0;
+    s.fade = 3.0;
+    s.loss = 0.0;
+    s.baud = 115200;
+    s.turnaround = VM_US(1000);
+    s.seed = 1;
+    so[0] = '\0';
+    while((opt = getopt(argc, argv, "n:d:b:j:w:r:p:i:x:s:f:l:B:t:S:o:L:")) != -1){
+        switch(opt){
+            case 'n': nodes = atol(optarg); break;
+            case 'd': days = atof(optarg); break;
+            case 'b': spread = atof(optarg); break;
+            case 'j': threads = atol(optarg); break;
+            case 'w': window = atof(optarg); break;
+            case 'r': radius = atof(optarg); break;
+            case 'p': positions = optarg; break;
+            case 'i': readings = optarg; break;
+            case 'x': s.exponent = atof(optarg); break;
+            case 's': s.shadow = atof(optarg); break;
+            case 'f': s.fade = atof(optarg); break;
+            case 'l': s.loss = atof(optarg); break;
+            case 'B': s.baud = atof(optarg); break;
+            case 't': s.turnaround = VM_US(atol(optarg)); break;
+            case 'S': s.seed = strtoull(optarg, NULL, 0); break;
+            case 'o': out = optarg; break;
+            case 'L': snprintf(so, sizeof(so), "%s", optarg); break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if(optind != argc || nodes < 1 || nodes > SIM_MAX_NODES || days <= 0 || spread < 0 || window <= 0 || threads < 1){
+        usage(argv[0]);
+        return 2;
+    }
+    if(so[0] == '\0'){                  // Next to this program by default
+        slash = strrchr(argv[0], '/');
+        snprintf(so, sizeof(so), "%.*ssimnode.so", slash ? (int)(slash - argv[0] + 1) : 0, argv[0]);
+    }
+    s.n = (uint16_t)nodes;
+    env.seed = s.seed;
+    if(readings != NULL && env_load(&env, readings) != 0){
+        fprintf(stderr, "can't read temperature or depth readings from %s\n", readings);
+        return 1;
+    }
+    if(sim_place(&s, positions, radius) != 0){
+        fprintf(stderr, "can't read %s\n", positions);
+        return 1;
+    }
+    if(out != NULL && (csv = fopen(out, "w")) == NULL){
+        fprintf(stderr, "can't open %s\n", out);
+        return 1;
+    }
+    link_init(&s.links);
+    gap_init(&s.gaps);
+    energy_init(&s.energy, EN_CAPACITY_MAH);
+    if(sim_load(&s, so, &env, spread) != 0){
+        fprintf(stderr, "can't load %s for every node\n", so);
+        return 1;
+    }
+    if(pool_start(&pool, s.nodes, (int)threads) != 0){
+        fprintf(stderr, "can't start the worker threads\n");
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    end = (VM_Time)(days * 86400.0 * VM_HZ);
+    for(t=0; t<end; ){
+        t = ((VM_Time)(window * VM_HZ) < end - t) ? t + (VM_Time)(window * VM_HZ) : end;
+        if(sim_window(&s, &pool, t, list) != 0){
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    wall = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    pool_stop(&pool);
+
+    sim_report(&s, VM_SECONDS(end), wall, csv);
+    if(csv != NULL && fclose(csv) != 0){
+        fprintf(stderr, "can't write %s\n", out);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * The base station side of over the air updates, see ota_send.h
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "../crc.h"
+#include "ota_send.h"
+
+#define HAVE(tx, c)     ((tx)->acked[(c) >> 3] & (1 << ((c) & 7)))
+
+int ota_send_init(OTA_Sender *tx, uint8_t node, const uint8_t *delta, uint16_t len){
+    if(len == 0 || len > OTA_STAGING_SIZE){
+        return -1;
+    }
+    memset(tx, 0, sizeof(*tx));
+    tx->node = node;
+    tx->delta = delta;
+    tx->len = len;
+    tx->crc = crc16(delta, len);
+    tx->chunks = (len + OTA_CHUNK - 1) / OTA_CHUNK;
+    tx->node_state = OTA_IDLE;
+    return 0;
+}
+
+/*
+ * Frame that starts or resumes the transfer on the node
+ */
+int ota_send_begin(const OTA_Sender *tx, PKT_Frame *pkt){
+    uint8_t args[4] = {tx->len & 0xFF, tx->len >> 8, tx->crc & 0xFF, tx->crc >> 8};
+    return pkt_control_init(pkt, tx->node, PKT_CMD_OTA_BEGIN, args, 4);
+}
+
+/*
+ * Next chunk the node doesn't have this round. Returns -1 at the end of the round, after which the
+ * node should be queried and ota_send_next() called again for the next round.
+ */
+int ota_send_next(OTA_Sender *tx, PKT_Frame *pkt){
+    uint8_t args[2 + OTA_CHUNK];
+    uint16_t offset, n;
+    while(tx->next < tx->chunks && HAVE(tx, tx->next)){
+        tx->next++;
+    }
+    if(tx->next >= tx->chunks){
+        tx->next = 0;
+        return -1;
+    }
+    offset = tx->next * OTA_CHUNK;
+    n = (tx->len - offset < OTA_CHUNK) ? tx->len - offset : OTA_CHUNK;
+    args[0] = tx->next & 0xFF;
+    args[1] = tx->next >> 8;
+    memcpy(&args[2], &tx->delta[offset], n);
+    tx->next++;
+    tx->frames++;
+    return pkt_control_init(pkt, tx->node, PKT_CMD_OTA_DATA, args, 2 + n);
+}
+
+int ota_send_query(const OTA_Sender *tx, PKT_Frame *pkt){
+    return pkt_control_init(pkt, tx->node, PKT_CMD_OTA_QUERY, NULL, 0);
+}
+
+int ota_send_commit(const OTA_Sender *tx, PKT_Frame *pkt){
+    return pkt_control_init(pkt, tx->node, PKT_CMD_OTA_COMMIT, NULL, 0);
+}
+
+/*
+ * Takes in the body of a PKT_OTA_STATUS from the node. Returns the node's OTA_State.
+ */
+int ota_send_status(OTA_Sender *tx, const uint8_t *status, uint8_t len){
+    uint16_t first, c, i;
+    if(len != OTA_STATUS_SIZE){
+        return -1;
+    }
+    tx->node_state = status[0];
+    first = status[3] | (status[4] << 8);
+    if((uint16_t)(status[1] | (status[2] << 8)) < tx->chunks - ota_send_missing(tx)){
+        memset(tx->acked, 0, sizeof(tx->acked));   // The node started over
+    }
+    for(c=0; c<first && c<tx->chunks; c++){     // Everything before the first missing chunk is in
+        tx->acked[c >> 3] |= 1 << (c & 7);
+    }
+    for(i=0; i<OTA_STATUS_WINDOW; i++){
+        c = first + i;
+        if(c >= tx->chunks){
+            break;
+        }
+        if(status[5 + (i >> 3)] & (1 << (i & 7))){
+            tx->acked[c >> 3] |= 1 << (c & 7);
+        }
+        else{
+            tx->acked[c >> 3] &= ~(1 << (c & 7));
+        }
+    }
+    return tx->node_state;
+}
+
+/*
+ * Chunks the node isn't known to have
+ */
+uint16_t ota_send_missing(const OTA_Sender *tx){
+    uint16_t c, n = 0;
+    for(c=0; c<tx->chunks; c++){
+        if(!HAVE(tx, c)){
+            n++;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,43 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * The base station side of over the air updates (see ota.h). A delta is sent in rounds: every chunk
+ * the node isn't known to have is sent once, then the node is asked for its status and the next
+ * round only sends what is still missing. A dropped link is picked up again with the same
+ * PKT_CMD_OTA_BEGIN, which the node answers with its status. otasend drives it through the gateway,
+ * otadelta over a simulated link.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include "../ota.h"
+#include "../packet.h"
+
+#ifndef OTA_SEND_H_
+#define OTA_SEND_H_
+
+typedef struct OTA_SenderStruct{
+    uint8_t node;
+    const uint8_t *delta;
+    uint16_t len;
+    uint16_t crc;
+    uint16_t chunks;
+    uint8_t acked[(OTA_MAX_CHUNKS + 7) / 8];    // Chunks the node has said it has
+    uint16_t next;                              // Next chunk to consider this round
+    uint8_t node_state;                         // OTA_State from the last status
+    uint32_t frames;                            // Data frames sent
+} OTA_Sender;
+
+int ota_send_init(OTA_Sender *tx, uint8_t node, const uint8_t *delta, uint16_t len);
+int ota_send_begin(const OTA_Sender *tx, PKT_Frame *pkt);
+int ota_send_next(OTA_Sender *tx, PKT_Frame *pkt);
+int ota_send_query(const OTA_Sender *tx, PKT_Frame *pkt);
+int ota_send_commit(const OTA_Sender *tx, PKT_Frame *pkt);
+int ota_send_status(OTA_Sender *tx, const uint8_t *status, uint8_t len);
+uint16_t ota_send_missing(const OTA_Sender *tx);
+
+#endif /* OTA_SEND_H_ */
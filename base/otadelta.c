@@ -0,0 +1,211 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Makes a firmware delta for an over the air update and checks it on the PC. The delta is sent
+ * through the node's own update code (ota.c, delta.c, boot.c) running on a RAM copy of the flash,
+ * over a simulated link that can lose frames, drop out part way and resume, and lose power while
+ * the bootloader is applying the update. The result has to match the new image exactly. The two
+ * images have to share a bootloader section, since nodes never rewrite theirs.
+ *
+ * usage: otadelta [-o out.delta] [-l loss %] [-d frames per session] [-c flash ops before power cut]
+ *                 [-s seed] old_image new_image
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <setjmp.h>
+#include "../crc.h"
+#include "../flash.h"
+#include "../ota.h"
+#include "../boot.h"
+#include "../packet.h"
+#include "flash_mem.h"
+#include "delta_gen.h"
+#include "ota_send.h"
+
+#define FRAME_AIR_MS        0.42            // 32 byte payload at 1 Mbps with preamble, address, and PLL settling
+#define MAX_SESSIONS        100
+
+static double loss = 0;                     // Chance of losing any one frame
+static long session_frames = -1;            // Frames before the link drops out, -1 for never
+static long budget;
+
+/*
+ * One frame over the simulated link. Returns 0 if it got through.
+ */
+static int link_send(void){
+    if(budget == 0){
+        return -1;
+    }
+    if(budget > 0){
+        budget--;
+    }
+    return (rand() / (RAND_MAX + 1.0)) < loss ? -1 : 0;
+}
+
+/*
+ * The node's side, as handle_control() in main.c does it. Fills status if the node answers.
+ */
+static int node_receive(const PKT_Frame *pkt, uint8_t *status){
+    uint8_t cmd;
+    const uint8_t *args;
+    int nargs = pkt_control_parse(pkt->buf, pkt->len, &cmd, &args);
+    switch(cmd){
+        case PKT_CMD_OTA_BEGIN:
+            ota_begin(args[0] | (args[1] << 8), args[2] | (args[3] << 8));
+            break;
+        case PKT_CMD_OTA_DATA:
+            ota_chunk(args[0] | (args[1] << 8), &args[2], nargs - 2);
+            return 0;
+        case PKT_CMD_OTA_COMMIT:
+            if(ota_commit() == 0){
+                return 1;
+            }
+            break;
+    }
+    ota_status(status);
+    return (link_send() == 0) ? 2 : 0;      // Status back to the base station
+}
+
+static void flash_image(const uint8_t *img){
+    int seg;
+    for(seg=0; seg<OTA_IMAGE_SEGS; seg++){
+        memcpy(&flash_mem[OTA_SEG_ADDR(seg)], &img[seg*FLASH_SEG_SIZE], FLASH_SEG_SIZE);
+    }
+}
+
+static int flash_matches(const uint8_t *img){
+    int seg;
+    for(seg=0; seg<OTA_IMAGE_SEGS; seg++){
+        if(memcmp(&flash_mem[OTA_SEG_ADDR(seg)], &img[seg*FLASH_SEG_SIZE], FLASH_SEG_SIZE)){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char **argv){
+    static uint8_t old_img[OTA_IMAGE_SIZE], new_img[OTA_IMAGE_SIZE], delta[OTA_STAGING_SIZE];
+    static uint8_t old_boot[OTA_BOOT_SIZE], new_boot[OTA_BOOT_SIZE];
+    const char *out = NULL;
+    long cut = -1;
+    unsigned seed = 1;
+    int opt;
+
+    while((opt = getopt(argc, argv, "o:l:d:c:s:")) != -1){
+        switch(opt){
+            case 'o': out = optarg; break;
+            case 'l': loss = atof(optarg) / 100.0; break;
+            case 'd': session_frames = atol(optarg); break;
+            case 'c': cut = atol(optarg); break;
+            case 's': seed = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-o out.delta] [-l loss %%] [-d frames per session] [-c flash ops before power cut] [-s seed] old_image new_image\n", argv[0]);
+                return 2;
+        }
+    }
+    if(argc - optind != 2){
+        fprintf(stderr, "usage: %s [-o out.delta] [-l loss %%] [-d frames per session] [-c flash ops before power cut] [-s seed] old_image new_image\n", argv[0]);
+        return 2;
+    }
+    if(image_load(argv[optind], old_img, old_boot) || image_load(argv[optind+1], new_img, new_boot)){
+        fprintf(stderr, "can't load images\n");
+        return 1;
+    }
+    if(memcmp(old_boot, new_boot, OTA_BOOT_SIZE) != 0){    // The new image would call into a bootloader the node doesn't have
+        fprintf(stderr, "bootloader sections differ, the new image can't be sent as an update\n");
+        return 1;
+    }
+    srand(seed);
+
+    long len = delta_make(old_img, new_img, delta, sizeof(delta));
+    if(len < 0){
+        fprintf(stderr, "delta doesn't fit in the %u byte staging area\n", OTA_STAGING_SIZE);
+        return 1;
+    }
+    uint16_t chunks = (len + OTA_CHUNK - 1) / OTA_CHUNK;
+    printf("image %u bytes, delta %ld bytes (%.1f%%), %u frames, %.1f ms on air\n",
+           OTA_IMAGE_SIZE, len, 100.0 * len / OTA_IMAGE_SIZE, chunks, chunks * FRAME_AIR_MS);
+    if(out != NULL){
+        FILE *f = fopen(out, "wb");
+        if(f == NULL || fwrite(delta, 1, len, f) != (size_t)len){
+            fprintf(stderr, "can't write %s\n", out);
+            return 1;
+        }
+        fclose(f);
+    }
+
+    // Send it to a simulated node
+    OTA_Sender tx;
+    PKT_Frame pkt;
+    uint8_t status[OTA_STATUS_SIZE];
+    int sessions = 0, rounds = 0, committed = 0;
+    flash_mem_reset();
+    flash_image(old_img);
+    ota_send_init(&tx, 1, delta, len);
+    while(!committed && sessions < MAX_SESSIONS){
+        sessions++;
+        budget = session_frames;
+        ota_send_begin(&tx, &pkt);
+        if(link_send() != 0 || node_receive(&pkt, status) != 2){
+            continue;
+        }
+        ota_send_status(&tx, status, OTA_STATUS_SIZE);
+        while(budget != 0){
+            rounds++;
+            while(ota_send_next(&tx, &pkt) == 0){
+                if(link_send() == 0){
+                    node_receive(&pkt, status);
+                }
+            }
+            ota_send_query(&tx, &pkt);
+            if(link_send() != 0 || node_receive(&pkt, status) != 2){
+                continue;
+            }
+            ota_send_status(&tx, status, OTA_STATUS_SIZE);
+            if(ota_send_missing(&tx) == 0){
+                ota_send_commit(&tx, &pkt);
+                if(link_send() != 0){
+                    continue;
+                }
+                int r = node_receive(&pkt, status);
+                if(r == 1){
+                    committed = 1;
+                    break;
+                }
+                fprintf(stderr, "node refused the delta, state %d\n", status[0]);
+                return 1;
+            }
+        }
+    }
+    if(!committed){
+        fprintf(stderr, "transfer didn't finish in %d sessions\n", MAX_SESSIONS);
+        return 1;
+    }
+    printf("sent in %d session(s), %d round(s), %lu data frames\n", sessions, rounds, (unsigned long)tx.frames);
+
+    // Bootloader, losing power part way if asked
+    jmp_buf env;
+    int cuts = 0;
+    if(cut >= 0){
+        flash_mem_cut_after(cut, &env);
+    }
+    while(setjmp(env) != 0){
+        cuts++;                             // Power came back, boot again
+    }
+    int applied = boot_apply();
+    if(applied != 1 || !flash_matches(new_img) || boot_image_crc() != crc16(new_img, OTA_IMAGE_SIZE)){
+        fprintf(stderr, "image after update doesn't match (boot_apply %d)\n", applied);
+        return 1;
+    }
+    printf("applied%s, %lu erases, %lu byte writes\n", cuts ? " after a power cut" : "", flash_erases, flash_writes);
+    return 0;
+}
@@ -0,0 +1,300 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Sends a firmware delta made by otadelta -o to a node through the gateway on the serial port, with
+ * the base station side of the transfer in ota_send.c. The node only listens just after a report, so
+ * each session starts (or resumes) with a PKT_CMD_OTA_BEGIN in the listen window after one, and the
+ * node then stays listening until it hears nothing for 2 s. Chunks are written a frame at a time,
+ * waiting for each to leave the UART so the gateway's radio keeps up, and each round ends with a query
+ * for the node's status. After the commit the node resets into the bootloader, and the update is
+ * confirmed by its next report being a boot report. A report without the boot flag means the commit
+ * was lost, so it's sent again in that report's listen window.
+ *
+ * Runs in place of ingestd, which needs the port too, so readings that arrive meanwhile aren't kept.
+ * As with ingestd, a file or pipe can stand in for the gateway with -r naming where frames to it go.
+ *
+ * usage: otasend [-b baud] [-r replies] [-s status wait ms] [-t report wait s] [-n sessions]
+ *                port_or_file node update.delta
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+#include "../fec.h"
+#include "../ota.h"
+#include "../packet.h"
+#include "fec_decode.h"
+#include "serial.h"
+#include "ota_send.h"
+
+#define STATUS_TRIES        2               // Queries without an answer before waiting for the next report
+
+static int in_fd, out_fd;
+static uint8_t node;
+static SER_Reframer reframer;
+static uint8_t in_buf[256];
+static size_t in_pos, in_len;
+static int ended = 0;                       // The input ended, nothing more will come
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Puts a frame on the air through the gateway, at level 0 as the node only takes those
+ */
+static int send_pkt(const PKT_Frame *pkt){
+    uint8_t air[FEC_FRAME_SIZE];
+    uint8_t out[FEC_FRAME_SIZE + SER_OVERHEAD];
+    int len;
+    fec_encode(0, pkt->buf, pkt->len, air);
+    len = ser_frame(air, FEC_FRAME_SIZE, out);
+    if(write(out_fd, out, len) != len){
+        return -1;                          // Lost, the same as on the air
+    }
+    if(isatty(out_fd)){
+        tcdrain(out_fd);                    // One frame in flight at a time
+    }
+    return 0;
+}
+
+/*
+ * Decodes a serial frame. Returns its packet type if it's from the node, otherwise -1.
+ */
+static int take(const uint8_t *payload, int n, FEC_Result *res){
+    if(n != FEC_FRAME_SIZE || fec_decode(payload, res) < 0 || res->data[0] != node){
+        return -1;
+    }
+    return pkt_type(res->data, res->len);
+}
+
+/*
+ * Waits up to ms for the next frame from the node. Returns its packet type with the frame decoded
+ * into *res, or -1 if none came.
+ */
+static int node_frame(int ms, FEC_Result *res){
+    struct pollfd pfd = {in_fd, POLLIN, 0};
+    double end = now() + ms / 1000.0;
+    const uint8_t *payload;
+    size_t used;
+    ssize_t got;
+    int n, type, left;
+
+    while(1){
+        n = ser_reframe(&reframer, &in_buf[in_pos], in_len - in_pos, &used, &payload);
+        in_pos += used;
+        if(n >= 0){
+            if((type = take(payload, n, res)) >= 0){
+                return type;
+            }
+            continue;
+        }
+        left = (end - now()) * 1000;
+        if(ended || left <= 0){
+            return -1;
+        }
+        if(poll(&pfd, 1, left) <= 0){
+            while((n = ser_reframe_idle(&reframer, &payload)) >= 0){  // Quiet line, a partial frame won't finish
+                if((type = take(payload, n, res)) >= 0){
+                    return type;
+                }
+            }
+            continue;
+        }
+        got = read(in_fd, in_buf, sizeof(in_buf));
+        if(got < 0 && errno == EINTR){
+            continue;
+        }
+        if(got <= 0){
+            ended = 1;
+            continue;
+        }
+        in_pos = 0;
+        in_len = got;
+    }
+}
+
+/*
+ * Waits for the node's answer to a frame and hands it to the sender. Returns the node's OTA_State,
+ * or -1 if it didn't answer.
+ */
+static int node_status(OTA_Sender *tx, int ms){
+    FEC_Result res;
+    const uint8_t *body;
+    double end = now() + ms / 1000.0;
+    int n;
+    while(now() < end && !ended){
+        if(node_frame((end - now()) * 1000 + 1, &res) == PKT_OTA_STATUS){
+            n = pkt_body(res.data, res.len, &body);
+            if(n == OTA_STATUS_SIZE){
+                return ota_send_status(tx, body, n);
+            }
+        }
+    }
+    return -1;
+}
+
+/*
+ * Waits for a report from the node. Returns its flags, or -1 if none came in time.
+ */
+static int node_report(int s){
+    FEC_Result res;
+    PKT_Report report;
+    double end = now() + s;
+    while(now() < end && !ended){
+        if(node_frame((end - now()) * 1000 + 1, &res) == PKT_REPORT && pkt_report_parse(res.data, res.len, &report) == 0){
+            return report.flags;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Waits for the node after a commit. A node that takes the update resets into the bootloader without
+ * answering and comes back with a boot report, one that refuses it answers with its status. Returns
+ * the flags of the node's next report, -2 if it refused (see tx->node_state), or -1 if it went quiet.
+ */
+static int node_restart(OTA_Sender *tx, int s){
+    FEC_Result res;
+    PKT_Report report;
+    const uint8_t *body;
+    double end = now() + s;
+    int type;
+    while(now() < end && !ended){
+        type = node_frame((end - now()) * 1000 + 1, &res);
+        if(type == PKT_OTA_STATUS && pkt_body(res.data, res.len, &body) == OTA_STATUS_SIZE){
+            ota_send_status(tx, body, OTA_STATUS_SIZE);
+            return -2;
+        }
+        if(type == PKT_REPORT && pkt_report_parse(res.data, res.len, &report) == 0){
+            return report.flags;
+        }
+    }
+    return -1;
+}
+
+int main(int argc, char **argv){
+    static uint8_t delta[OTA_STAGING_SIZE + 1];
+    const char *replies = NULL;
+    long baud = 115200;
+    int status_ms = 500, report_s = 3600, sessions = 20;
+    int opt, session, tries, flags, sent = 0;
+    OTA_Sender tx;
+    PKT_Frame pkt;
+    FILE *f;
+    size_t len;
+
+    while((opt = getopt(argc, argv, "b:r:s:t:n:")) != -1){
+        switch(opt){
+            case 'b': baud = atol(optarg); break;
+            case 'r': replies = optarg; break;
+            case 's': status_ms = atoi(optarg); break;
+            case 't': report_s = atoi(optarg); break;
+            case 'n': sessions = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-b baud] [-r replies] [-s status wait ms] [-t report wait s] [-n sessions] port_or_file node update.delta\n", argv[0]);
+                return 2;
+        }
+    }
+    if(argc - optind != 3){
+        fprintf(stderr, "usage: %s [-b baud] [-r replies] [-s status wait ms] [-t report wait s] [-n sessions] port_or_file node update.delta\n", argv[0]);
+        return 2;
+    }
+    node = atoi(argv[optind+1]);
+    f = fopen(argv[optind+2], "rb");
+    if(f == NULL){
+        fprintf(stderr, "can't open %s\n", argv[optind+2]);
+        return 1;
+    }
+    len = fread(delta, 1, sizeof(delta), f);
+    fclose(f);
+    if(ota_send_init(&tx, node, delta, len) != 0){
+        fprintf(stderr, "%s is empty or bigger than the %u byte staging area\n", argv[optind+2], OTA_STAGING_SIZE);
+        return 1;
+    }
+    in_fd = ser_open(argv[optind], baud);
+    if(in_fd < 0){
+        fprintf(stderr, "can't open %s at %ld baud\n", argv[optind], baud);
+        return 1;
+    }
+    out_fd = isatty(in_fd) ? in_fd : -1;
+    if(replies != NULL && (out_fd = ser_open_reply(replies)) < 0){
+        fprintf(stderr, "can't open %s for replies\n", replies);
+        return 1;
+    }
+    if(out_fd < 0){
+        fprintf(stderr, "%s isn't a serial port, name where frames to the gateway go with -r\n", argv[optind]);
+        return 1;
+    }
+    ser_reframe_init(&reframer);
+    printf("%u byte delta, %u chunks, to node %u\n", tx.len, tx.chunks, node);
+
+    for(session=0; session<sessions && !sent; session++){
+        if(node_report(report_s) < 0){
+            fprintf(stderr, "no report from node %u\n", node);
+            return 1;
+        }
+        ota_send_begin(&tx, &pkt);
+        send_pkt(&pkt);
+        if(node_status(&tx, status_ms) < 0){
+            continue;                       // Missed the window, try after the next report
+        }
+        tries = 0;
+        while(tries < STATUS_TRIES && !sent){
+            while(ota_send_next(&tx, &pkt) == 0){
+                send_pkt(&pkt);
+            }
+            ota_send_query(&tx, &pkt);
+            send_pkt(&pkt);
+            if(node_status(&tx, status_ms) < 0){
+                tries++;
+                continue;
+            }
+            tries = 0;
+            printf("session %d: %u of %u chunks in\n", session + 1, tx.chunks - ota_send_missing(&tx), tx.chunks);
+            sent = ota_send_missing(&tx) == 0;
+        }
+    }
+    if(!sent){
+        fprintf(stderr, "transfer didn't finish in %d sessions\n", sessions);
+        return 1;
+    }
+    printf("sent, %lu data frames\n", (unsigned long)tx.frames);
+
+    // Commit while the node is still listening, and again after each report until it resets
+    for(tries=0; ; tries++){
+        ota_send_commit(&tx, &pkt);
+        send_pkt(&pkt);
+        flags = node_restart(&tx, report_s);
+        if(flags == -2){
+            fprintf(stderr, "node refused the delta, state %d\n", tx.node_state);
+            return 1;
+        }
+        if(flags < 0){
+            fprintf(stderr, "no report from node %u since the commit\n", node);
+            return 1;
+        }
+        if(flags & PKT_F_BOOT){
+            break;
+        }
+        if(tries + 1 >= sessions){
+            fprintf(stderr, "node %u didn't reset after %d commits\n", node, tries + 1);
+            return 1;
+        }
+    }
+    printf("node %u is back up\n", node);
+    return 0;
+}
@@ -0,0 +1,160 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Replays a recorded sensor trace through the node's adaptive sampling (sample.c) and compares it to
+ * sampling at a fixed period. The trace is CSV lines of time in seconds and a reading in the units the
+ * node reports (C for temperature, mm for depth), sorted by time.
+ *
+ * Reported per policy: samples taken, mean absolute error of holding the last sample against every
+ * trace point, and the worst delay between the trace crossing the setpoint and a sample seeing it.
+ *
+ * usage: sampletrace [-m min s] [-M max s] [-r rate limit per h] [-p setpoint] [-b band] trace.csv
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../sample.h"
+
+typedef struct TracePointStruct{
+    long t;
+    int16_t value;
+} TracePoint;
+
+typedef struct ResultStruct{
+    long samples;
+    double mean_err;
+    long worst_delay;                       // Seconds, -1 if the trace never crosses the setpoint
+    long missed;                            // Crossings no sample saw before the trace crossed back
+} Result;
+
+static TracePoint *trace;
+static long npoints;
+
+static int trace_load(const char *path){
+    FILE *f = fopen(path, "r");
+    long cap = 1024;
+    char line[128];
+    double t, v;
+    if(f == NULL){
+        return -1;
+    }
+    trace = malloc(cap * sizeof(*trace));
+    npoints = 0;
+    while(fgets(line, sizeof(line), f) != NULL){
+        if(sscanf(line, "%lf,%lf", &t, &v) != 2){
+            continue;                       // Header or blank line
+        }
+        if(npoints == cap){
+            cap *= 2;
+            trace = realloc(trace, cap * sizeof(*trace));
+        }
+        trace[npoints].t = (long)t;
+        trace[npoints].value = (int16_t)(v < 0 ? v - 0.5 : v + 0.5);
+        npoints++;
+    }
+    fclose(f);
+    return (npoints > 1) ? 0 : -1;
+}
+
+/*
+ * Side of the setpoint a reading is on, readings on it count as above
+ */
+static int side(int16_t value, int16_t setpoint){
+    return value >= setpoint;
+}
+
+/*
+ * Runs a sensor over the trace. With adaptive = 0 the sensor is sampled at its minimum period.
+ */
+static Result replay(SMP_Sensor *s, int adaptive){
+    Result r = {0, 0, -1, 0};
+    long t = trace[0].t, i = 0, next = trace[0].t;
+    long crossed_at = -1;
+    int16_t held = 0;
+    int seen_side = -1, true_side = side(trace[0].value, s->setpoint);
+    double err = 0;
+
+    for(i=0; i<npoints; i++){
+        while(next <= trace[i].t){          // Take every sample due up to this point of the trace
+            t = next;
+            held = trace[(i > 0 && trace[i].t > t) ? i-1 : i].value;
+            r.samples++;
+            if(crossed_at >= 0 && side(held, s->setpoint) == true_side){
+                if(t - crossed_at > r.worst_delay){
+                    r.worst_delay = t - crossed_at;
+                }
+                crossed_at = -1;
+            }
+            seen_side = side(held, s->setpoint);
+            next = t + (adaptive ? smp_update(s, held) : s->min_period);
+        }
+        if(side(trace[i].value, s->setpoint) != true_side){
+            true_side = !true_side;
+            if(true_side != seen_side && crossed_at < 0){
+                crossed_at = trace[i].t;
+            }
+            else if(true_side == seen_side && crossed_at >= 0){
+                r.missed++;                 // Went back before any sample saw it
+                crossed_at = -1;
+            }
+        }
+        err += abs(trace[i].value - held);
+    }
+    r.mean_err = err / npoints;
+    return r;
+}
+
+static void usage(const char *prog){
+    fprintf(stderr, "usage: %s [-m min s] [-M max s] [-r rate limit per h] [-p setpoint] [-b band] trace.csv\n", prog);
+}
+
+int main(int argc, char **argv){
+    uint16_t min = 300, max = 3600, rate = 2, band = 2;
+    int16_t setpoint = 0;
+    SMP_Sensor s;
+    Result fixed, adapt;
+    int opt;
+
+    while((opt = getopt(argc, argv, "m:M:r:p:b:")) != -1){
+        switch(opt){
+            case 'm': min = atoi(optarg); break;
+            case 'M': max = atoi(optarg); break;
+            case 'r': rate = atoi(optarg); break;
+            case 'p': setpoint = atoi(optarg); break;
+            case 'b': band = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if(argc - optind != 1){
+        usage(argv[0]);
+        return 2;
+    }
+    if(trace_load(argv[optind])){
+        fprintf(stderr, "can't load a trace from %s\n", argv[optind]);
+        return 1;
+    }
+    if(smp_init(&s, min, max, rate, setpoint, band)){
+        fprintf(stderr, "bad sampling bounds\n");
+        return 1;
+    }
+
+    fixed = replay(&s, 0);
+    smp_init(&s, min, max, rate, setpoint, band);
+    adapt = replay(&s, 1);
+
+    printf("%ld points over %.1f h\n", npoints, (trace[npoints-1].t - trace[0].t) / 3600.0);
+    printf("%-9s %8s %10s %14s %7s\n", "policy", "samples", "mean err", "worst delay s", "missed");
+    printf("%-9s %8ld %10.2f %14ld %7ld\n", "fixed", fixed.samples, fixed.mean_err, fixed.worst_delay, fixed.missed);
+    printf("%-9s %8ld %10.2f %14ld %7ld\n", "adaptive", adapt.samples, adapt.mean_err, adapt.worst_delay, adapt.missed);
+    printf("adaptive takes %.1f%% of the samples\n", 100.0 * adapt.samples / fixed.samples);
+    return 0;
+}
@@ -0,0 +1,193 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Framing on the UART between the gateway node and the base station, see serial.h
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/stat.h>
+#include "../crc.h"
+#include "serial.h"
+
+void ser_reframe_init(SER_Reframer *r){
+    memset(r, 0, sizeof(*r));
+}
+
+/*
+ * Looks for a good frame at the front of the buffer, throwing away bytes that can't start one.
+ * Returns the payload length or -1 if more bytes are needed.
+ */
+static int ser_scan(SER_Reframer *r){
+    uint16_t drop, n;
+    while(r->len > 0){
+        for(drop=0; drop<r->len; drop++){           // Up to something that could be a sync
+            if(r->buf[drop] == SER_SYNC0 && (drop + 1 == r->len || r->buf[drop+1] == SER_SYNC1)){
+                break;
+            }
+        }
+        if(drop > 0){
+            r->skipped += drop;
+            r->len -= drop;
+            memmove(r->buf, &r->buf[drop], r->len);
+        }
+        if(r->len < SER_OVERHEAD || r->len < SER_OVERHEAD + r->buf[2]){
+            return -1;
+        }
+        n = r->buf[2];
+        if(crc16(&r->buf[2], 1 + n) == (r->buf[3+n] | (r->buf[4+n] << 8))){
+            r->frames++;
+            r->done = n + SER_OVERHEAD;
+            return n;
+        }
+        r->bad_crc++;                               // Hunt again from just after the false sync
+        r->skipped++;
+        r->len--;
+        memmove(r->buf, &r->buf[1], r->len);
+    }
+    return -1;
+}
+
+/*
+ * Feeds bytes from the UART. Takes bytes from data until a frame is finished, setting *used to the
+ * bytes taken. Returns the payload length and points *payload at it, which is only valid until the
+ * next call, or -1 once all len bytes are used without finishing a frame.
+ */
+int ser_reframe(SER_Reframer *r, const uint8_t *data, size_t len, size_t *used, const uint8_t **payload){
+    size_t i = 0;
+    int n;
+    if(r->done){                                    // Drop the frame handed out last time
+        r->len -= r->done;
+        memmove(r->buf, &r->buf[r->done], r->len);
+        r->done = 0;
+    }
+    while(1){
+        n = ser_scan(r);
+        if(n >= 0){
+            *payload = &r->buf[3];
+            *used = i;
+            return n;
+        }
+        if(i == len){
+            *used = i;
+            return -1;
+        }
+        r->buf[r->len++] = data[i++];               // Never overflows, the scan leaves less than a frame
+    }
+}
+
+/*
+ * Gives up on a frame in progress when the line goes quiet or the input ends, since the gateway sends
+ * each frame in one go. A false sync could be holding back good frames behind it, so those are
+ * returned one per call the same way as ser_reframe(), then -1 once nothing is left.
+ */
+int ser_reframe_idle(SER_Reframer *r, const uint8_t **payload){
+    size_t used;
+    int n;
+    while(1){
+        n = ser_reframe(r, NULL, 0, &used, payload);
+        if(n >= 0 || r->len == 0){
+            return n;
+        }
+        r->skipped++;                               // Can't finish, drop the start of it and look again
+        r->len--;
+        memmove(r->buf, &r->buf[1], r->len);
+    }
+}
+
+/*
+ * Wraps a payload for the UART. out needs len + SER_OVERHEAD bytes. Returns the framed length.
+ */
+int ser_frame(const uint8_t *payload, uint8_t len, uint8_t *out){
+    out[0] = SER_SYNC0;
+    out[1] = SER_SYNC1;
+    out[2] = len;
+    memcpy(&out[3], payload, len);
+    uint16_t crc = crc16(&out[2], 1 + len);
+    out[3+len] = crc & 0xFF;
+    out[4+len] = crc >> 8;
+    return len + SER_OVERHEAD;
+}
+
+/*
+ * Opens the gateway's serial port raw at a baud rate for reading and writing, or a file or pipe to
+ * stand in for it read only ("-" is stdin). Replies to a stand-in go wherever ser_open_reply() points
+ * them. Returns the file descriptor or -1.
+ */
+int ser_open(const char *path, long baud){
+    struct termios tio;
+    struct stat st;
+    speed_t speed;
+    int fd;
+
+    if(strcmp(path, "-") == 0){
+        return STDIN_FILENO;
+    }
+    if(stat(path, &st) != 0){
+        return -1;
+    }
+    if(!S_ISCHR(st.st_mode)){
+        return open(path, O_RDONLY);    // File or pipe
+    }
+    fd = open(path, O_RDWR | O_NOCTTY);
+    if(fd < 0){
+        return -1;
+    }
+    if(!isatty(fd)){
+        close(fd);
+        return open(path, O_RDONLY);
+    }
+    switch(baud){
+        case 9600: speed = B9600; break;
+        case 19200: speed = B19200; break;
+        case 38400: speed = B38400; break;
+        case 57600: speed = B57600; break;
+        case 115200: speed = B115200; break;
+        case 230400: speed = B230400; break;
+        case 460800: speed = B460800; break;
+        case 921600: speed = B921600; break;
+        default:
+            close(fd);
+            return -1;
+    }
+    if(tcgetattr(fd, &tio) != 0){
+        close(fd);
+        return -1;
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 1;                 // Block for at least a byte, then take whatever is there
+    tio.c_cc[VTIME] = 0;
+    if(tcsetattr(fd, TCSANOW, &tio) != 0){
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/*
+ * Opens a file or pipe for the frames a stand-in for the gateway would put on the air, appending to
+ * a file. Writes never block, so a pipe nobody drains drops frames the way the air would. Returns
+ * the file descriptor or -1.
+ */
+int ser_open_reply(const char *path){
+    int fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if(fd < 0){
+        return -1;
+    }
+    if(fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0){
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
@@ -0,0 +1,52 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Framing on the UART between the gateway node and the base station. The gateway passes every frame
+ * it hears on the air through as is (a 32 byte fec.h codeword) and sends frames from the base station
+ * back out on the air, so the base station does all of the decoding.
+ *
+ * Serial frame layout
+ *  [0..1]  SER_SYNC0, SER_SYNC1
+ *  [2]     Payload length, n
+ *  [3..]   Payload
+ *  [...]   CRC-16-CCITT (crc.h) over the length and payload, little endian
+ *
+ * The reframer hunts for the sync bytes, and on a bad CRC starts hunting again one byte after the
+ * false sync so a sync pattern inside a payload can't swallow the frame after it. The gateway sends
+ * each frame in one go, so a frame still unfinished when the line goes quiet was a false sync too.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef SERIAL_H_
+#define SERIAL_H_
+
+#define SER_SYNC0           0x7E
+#define SER_SYNC1           0x81
+#define SER_MAX_PAYLOAD     255
+#define SER_OVERHEAD        5           // Sync, length, and CRC
+#define SER_MAX_FRAME       (SER_OVERHEAD + SER_MAX_PAYLOAD)
+
+typedef struct SER_ReframerStruct{
+    uint8_t buf[SER_MAX_FRAME];
+    uint16_t len;                       // Bytes held in buf
+    uint16_t done;                      // Bytes of the frame last handed out, dropped on the next call
+    uint64_t frames;                    // Good frames
+    uint64_t bad_crc;
+    uint64_t skipped;                   // Bytes thrown away hunting for a sync
+} SER_Reframer;
+
+void ser_reframe_init(SER_Reframer *r);
+int ser_reframe(SER_Reframer *r, const uint8_t *data, size_t len, size_t *used, const uint8_t **payload);
+int ser_reframe_idle(SER_Reframer *r, const uint8_t **payload);
+int ser_frame(const uint8_t *payload, uint8_t len, uint8_t *out);
+int ser_open(const char *path, long baud);
+int ser_open_reply(const char *path);
+
+#endif /* SERIAL_H_ */
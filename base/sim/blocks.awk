@@ -0,0 +1,78 @@
+# Author: Evan Jones III
+# Initial Commit: 10/19/2026
+# Last Commit: 10/19/2026
+#
+# Tables what the code between register accesses would cost on the G2553, for the virtual CPU in
+# g2553.c. Reads the gcc -S output of a firmware source built with -fsanitize-coverage=trace-pc,
+# which calls __sanitizer_cov_trace_pc() at the start of every basic block, labels where each call
+# returns to, and adds a vm_blocks section of (return address, cycles) pairs for it to look up.
+#
+# A block costs INSN cycles per host instruction in it, plus a __mspabi_* helper call for each
+# multiply or divide, as the G2553 has neither. The host's instructions are wider than the G2553's
+# and its compiler picks different ones, so this is an estimate, not a cycle count. Calls to
+# vm_reg8() and vm_reg16() are left out, they're the register accesses VM_ACCESS_CYCLES charges.
+# Takes x86-64 and AArch64 assembly.
+#
+# This work is covered under the MIT License
+# For license information, refer to the license file
+
+BEGIN {
+    INSN = 3                            # Cycles per host instruction, about an MSP430 one with a memory operand
+    MUL = 100                           # __mspabi_mpyi/__mspabi_mpyl
+    DIV = 300                           # __mspabi_divi/__mspabi_divul and the rest
+    n = 0
+    cur = 0                             # Block being counted, 0 before the first call after a label
+    pending = 0                         # Cycles since that label, the next block's
+}
+
+# A label or section starts a new block, whose trace call comes after what's counted to pending
+/^[A-Za-z_.$][A-Za-z0-9_.$]*:/ || /^[ \t]*\.(text|section|previous|pushsection|popsection)/ {
+    cur = 0
+    pending = 0
+    print
+    next
+}
+
+# Directives and blank lines
+/^[ \t]*(\.|#|\/\/|$)/ {
+    print
+    next
+}
+
+{
+    op = $1
+    cost = INSN
+    if($0 ~ /(call|bl)[ \t]+__sanitizer_cov_trace_pc/){
+        n++
+        print
+        print ".Lvm_block" n ":"
+        cycles[n] = pending
+        pending = 0
+        cur = n
+        next
+    }
+    if($0 ~ /(call|bl)[ \t]+vm_reg(8|16)([^A-Za-z0-9_]|$)/){
+        cost = 0
+    }else if(op ~ /^i?mul[bwlq]?$/ || op ~ /^(mul|madd|msub|mneg|[su]mull|[su]mulh|[su]maddl|[su]msubl)$/){
+        cost += MUL
+    }else if(op ~ /^i?div[bwlq]?$/ || op ~ /^[su]div$/){
+        cost += DIV
+    }
+    if(cur){
+        cycles[cur] += cost
+    }else{
+        pending += cost
+    }
+    print
+}
+
+END {
+    if(n == 0){
+        exit
+    }
+    print "\t.section\tvm_blocks,\"aw\""
+    print "\t.balign\t8"
+    for(i=1; i<=n; i++){
+        print "\t.quad\t.Lvm_block" i ", " cycles[i]
+    }
+}
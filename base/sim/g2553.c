@@ -0,0 +1,969 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Virtual MSP430G2553 for the network simulator, see vm.h. Models what the firmware in this repo uses:
+ *
+ *  clocks          DCO at the calibrated 1, 8, 12, or 16 MHz; ACLK at 32768 Hz; SMCLK = MCLK
+ *  Timer0/1_A      continuous mode, CCR0 compare, CCR1 compare or capture of P2.1, overflow, TAxIV
+ *  USCI A0/B0      SPI master, double buffered, 8 bit clocks a byte; B0 talks to the nRF24 (nrf24.c)
+ *  ADC10           single conversions and sequences, MSC, and the DTC into VM_RAM; the temperature
+ *                  channel reads the environment, the rest mid-scale
+ *  P2.0/P2.1       ultrasonic trigger and echo, the echo timed from the environment's snow depth
+ *  status register GIE and the low power mode bits, interrupts in the G2553's priority order
+ *  watchdog        a write without the password halts the node
+ *
+ * A register write is acted on at the next register access or intrinsic, the way a peripheral sees
+ * it a cycle or two late. The code between them is charged by basic block, at what sim/blocks.awk
+ * estimated each would take on the G2553.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <ucontext.h>
+#include "msp430g2553.h"
+#include "vm.h"
+#include "../flash_mem.h"
+#include "../../packet.h"
+#include "../../sensors.h"
+
+#define VM_ON_READ          0x01        // Hooks per register
+#define VM_ON_WRITE         0x02
+
+#define VM_ACLK_TICK        (VM_HZ / 32768)
+#define VM_ADC10OSC_TICK    (VM_HZ / 5000000)   // ~5 MHz
+#define VM_ECHO_DELAY       VM_US(460)          // Trigger to echo rising, the sensor's burst
+#define VM_ECHO_MISS        0.02                // Chance a ping gets no echo
+#define VM_ECHO_STRAY       0.02                // Chance of an early echo off something else
+#define VM_BLOCK_CACHE      256                 // Basic block costs kept at hand, a power of 2
+
+// Factory calibration, what a typical part has in info segment A
+#define VM_CAL_1MHZ         0x86
+#define VM_CAL_8MHZ         0x8D
+#define VM_CAL_12MHZ        0x8E
+#define VM_CAL_16MHZ        0x8F
+
+typedef struct VM_TimerStruct{
+    VM_Reg ctl, r, cctl0, ccr0, cctl1, ccr1, iv;
+    uint8_t running;
+    VM_Time tick;                       // Time per count
+    VM_Time base;                       // Time the count was 0, while running
+    uint64_t frozen;                    // Count while stopped
+    VM_Time ccr0_after;                 // Compare and overflow events up to here were handled
+    VM_Time ccr1_after;
+    VM_Time ovf_after;
+} VM_Timer;
+
+typedef struct VM_UsciStruct{
+    VM_Reg ctl1, br0, br1, stat, rxbuf, txbuf;
+    uint8_t rxifg, txifg;
+    uint8_t queued, next;               // Byte waiting in TXBUF
+    uint8_t shifting, shift;            // Byte in the shift register
+    VM_Time load;                       // TXBUF moves to the shift register
+    VM_Time done;                       // Shift register empties
+} VM_Usci;
+
+VM_Node vm_node;
+VM_Time vm_now = 0;
+uint8_t vm_node_id = 1;
+
+static uint16_t vm_regs[VM_NUM_REGS];
+static uint8_t vm_hooks[VM_NUM_REGS];
+static int vm_pending = -1;             // Register accessed last, acted on at the next access
+static uint16_t vm_sr = 0;
+static uint16_t vm_isr_sr;              // Saved on the stack by an interrupt
+static uint8_t vm_in_isr = 0;
+static uint8_t vm_mhz = 1;
+static VM_Time vm_cycle = VM_HZ / 1000000;
+static VM_Time vm_next = 0;             // Next peripheral event
+static uint8_t vm_dirty = 1;            // vm_next needs working out again
+static VM_Time vm_accounted = 0;
+static uint64_t vm_rng;
+static ucontext_t vm_host, vm_self;
+char *vm_stack;
+
+static VM_Timer vm_timers[2] = {
+    {.ctl = VM_TA0CTL, .r = VM_TA0R, .cctl0 = VM_TA0CCTL0, .ccr0 = VM_TA0CCR0, .cctl1 = VM_TA0CCTL1,
+     .ccr1 = VM_TA0CCR1, .iv = VM_TA0IV},
+    {.ctl = VM_TA1CTL, .r = VM_TA1R, .cctl0 = VM_TA1CCTL0, .ccr0 = VM_TA1CCR0, .cctl1 = VM_TA1CCTL1,
+     .ccr1 = VM_TA1CCR1, .iv = VM_TA1IV},
+};
+static VM_Usci vm_usci[2] = {
+    {.ctl1 = VM_UCA0CTL1, .br0 = VM_UCA0BR0, .br1 = VM_UCA0BR1, .stat = VM_UCA0STAT, .rxbuf = VM_UCA0RXBUF,
+     .txbuf = VM_UCA0TXBUF, .rxifg = UCA0RXIFG, .txifg = UCA0TXIFG},
+    {.ctl1 = VM_UCB0CTL1, .br0 = VM_UCB0BR0, .br1 = VM_UCB0BR1, .stat = VM_UCB0STAT, .rxbuf = VM_UCB0RXBUF,
+     .txbuf = VM_UCB0TXBUF, .rxifg = UCB0RXIFG, .txifg = UCB0TXIFG},
+};
+
+static uint8_t vm_adc_busy = 0;
+static VM_Time vm_adc_done = VM_NEVER;
+static int8_t vm_adc_ch = -1;           // Channel converting or next in a sequence, -1 between them
+static uint8_t vm_dtc_left = 0;         // Transfers left in the DTC's block
+static uint16_t vm_dtc_addr;
+uint8_t vm_ram[VM_RAM_SIZE];
+static uint8_t vm_trigger = 0;          // P2.0 level
+static VM_Time vm_trigger_rise;
+static VM_Time vm_echo_rise = VM_NEVER;
+static VM_Time vm_echo_fall = VM_NEVER;
+static uint8_t vm_ranging = 0;          // Ranger draws its working current from the trigger to the echo
+static uint8_t vm_csn = 1, vm_ce = 0;
+static uint32_t vm_owed = 0;            // CPU cycles of code run since time last moved
+
+#define R(reg)  vm_regs[VM_##reg]
+
+int main(void);
+void TIMER0_A0_ISR(void);
+void TIMER0_A1_ISR(void);
+void TIMER1_A0_ISR(void);
+void TIMER1_A1_ISR(void);
+void USCIAB0TX_ISR(void);
+void USCIAB0RX_ISR(void);
+void ADC10_ISR(void);
+extern const uint16_t pwr_ua[PWR_NUM_STATES];
+
+static void vm_advance(VM_Time target);
+static void vm_halt(const char *why);
+
+/*
+ * Helpers
+ */
+uint64_t vm_random(void){
+    uint64_t z = (vm_rng += 0x9E3779B97F4A7C15ULL);     // splitmix64
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/*
+ * Starts the random numbers (echo misses, ADC dither) over, ex: so each benchmark case sees the same
+ */
+void vm_reseed(uint64_t seed){
+    vm_rng = seed;
+}
+
+static double vm_uniform(void){
+    return (vm_random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+VM_Time vm_smclk_cycles(uint32_t cycles){
+    return cycles * vm_cycle;
+}
+
+void vm_changed(void){
+    vm_dirty = 1;
+}
+
+static double vm_env(uint8_t sensor){
+    return vm_node.env(vm_node.env_ctx, vm_node.id, sensor, VM_SECONDS(vm_now));
+}
+
+/*
+ * Charges the time since the last call to the state every part was in. Called before any of them
+ * changes state.
+ */
+void vm_account(void){
+    VM_Time d = vm_now - vm_accounted;
+    if(d == 0){
+        return;
+    }
+    if(!(vm_sr & CPUOFF)){
+        vm_node.spent[(vm_mhz >= 16) ? PWR_ACTIVE_16MHZ : (vm_mhz >= 12) ? PWR_ACTIVE_12MHZ
+                      : (vm_mhz >= 8) ? PWR_ACTIVE_8MHZ : PWR_ACTIVE_1MHZ] += d;
+    }
+    else{
+        vm_node.spent[(vm_sr & SCG1) ? PWR_LPM3 : PWR_LPM0] += d;
+    }
+    if(vm_adc_busy){
+        vm_node.spent[PWR_ADC_REF] += d;
+    }
+    vm_node.spent[nrf_state()] += d;
+    vm_node.spent[PWR_BOARD_FLOOR] += d;
+    vm_node.spent[vm_ranging ? PWR_RANGER_PING : PWR_RANGER_IDLE] += d;
+    vm_accounted = vm_now;
+}
+
+/*
+ * Coroutine
+ */
+static void vm_yield(VM_Status status){
+    vm_account();
+    vm_node.now = vm_now;
+    vm_node.status = status;
+    swapcontext(&vm_self, &vm_host);
+}
+
+/*
+ * Gives control back until the simulator has resolved the air up to now and emptied the outbox
+ */
+void vm_block(void){
+    while(vm_node.heard < vm_now || vm_node.nout == VM_OUTBOX){
+        vm_yield(VM_BLOCKED);
+    }
+}
+
+static void vm_halt(const char *why){
+    vm_node.halt = why;
+    for(;;){
+        vm_yield(VM_HALTED);
+    }
+}
+
+static void vm_entry(void){
+    if(vm_node.entry != NULL){
+        vm_node.entry();
+    }
+    else{
+        main();
+    }
+    vm_halt("main returned");
+}
+
+/*
+ * Timer_A
+ */
+static uint64_t vm_timer_count(VM_Timer *t, VM_Time at){
+    return t->running ? (at - t->base) / t->tick : t->frozen;
+}
+
+// Next time the count passes ccr after a time
+static VM_Time vm_timer_compare(VM_Timer *t, uint16_t ccr, VM_Time after){
+    uint64_t k = vm_timer_count(t, after) + 1;
+    k += (uint16_t)(ccr - (uint16_t)k);
+    return t->base + k * t->tick;
+}
+
+static VM_Time vm_timer_overflow(VM_Timer *t, VM_Time after){
+    uint64_t k = (vm_timer_count(t, after) / 65536 + 1) * 65536;
+    return t->base + k * t->tick;
+}
+
+static void vm_timer_ctl(VM_Timer *t){
+    uint16_t ctl = vm_regs[t->ctl];
+    uint64_t count = vm_timer_count(t, vm_now);
+    uint8_t running = (ctl & MC_MASK) != MC_0;
+
+    if((ctl & MC_MASK) != MC_0 && (ctl & MC_MASK) != MC_2){
+        vm_halt("Timer_A up and up/down modes aren't modelled");
+    }
+    t->tick = ((ctl & TASSEL_MASK) == TASSEL_1) ? VM_ACLK_TICK : vm_cycle;
+    t->tick <<= (ctl & ID_MASK) >> 6;
+    if(ctl & TACLR){
+        count = 0;
+        vm_regs[t->ctl] &= ~TACLR;
+    }
+    if(running){
+        t->base = vm_now - count * t->tick;     // Wraps if the count is from a faster clock, still right mod 2^64
+    }
+    else{
+        t->frozen = count;
+    }
+    if((ctl & TACLR) || (running && !t->running)){
+        t->ccr0_after = t->ccr1_after = t->ovf_after = vm_now;
+    }
+    t->running = running;
+}
+
+static int vm_timer_armed(VM_Timer *t, VM_Reg cctl){
+    return t->running && (vm_regs[cctl] & (CCIE | CAP)) == CCIE;
+}
+
+static VM_Time vm_timer_next(VM_Timer *t){
+    VM_Time next = VM_NEVER, at;
+    if(vm_timer_armed(t, t->cctl0) && (at = vm_timer_compare(t, vm_regs[t->ccr0], t->ccr0_after)) < next){
+        next = at;
+    }
+    if(vm_timer_armed(t, t->cctl1) && (at = vm_timer_compare(t, vm_regs[t->ccr1], t->ccr1_after)) < next){
+        next = at;
+    }
+    if(t->running && (vm_regs[t->ctl] & TAIE) && (at = vm_timer_overflow(t, t->ovf_after)) < next){
+        next = at;
+    }
+    return next;
+}
+
+static void vm_timer_events(VM_Timer *t){
+    VM_Time at;
+    if(vm_timer_armed(t, t->cctl0) && (at = vm_timer_compare(t, vm_regs[t->ccr0], t->ccr0_after)) <= vm_now){
+        vm_regs[t->cctl0] |= CCIFG;
+        t->ccr0_after = at;
+    }
+    if(vm_timer_armed(t, t->cctl1) && (at = vm_timer_compare(t, vm_regs[t->ccr1], t->ccr1_after)) <= vm_now){
+        vm_regs[t->cctl1] |= CCIFG;
+        t->ccr1_after = at;
+    }
+    if(t->running && (vm_regs[t->ctl] & TAIE) && (at = vm_timer_overflow(t, t->ovf_after)) <= vm_now){
+        vm_regs[t->ctl] |= TAIFG;
+        t->ovf_after = at;
+    }
+}
+
+static void vm_timer_iv(VM_Timer *t){
+    if(vm_regs[t->cctl1] & CCIFG){      // Reading TAxIV clears the flag it reports
+        vm_regs[t->iv] = TA0IV_TACCR1;
+        vm_regs[t->cctl1] &= ~CCIFG;
+    }
+    else if(vm_regs[t->ctl] & TAIFG){
+        vm_regs[t->iv] = TA0IV_TAIFG;
+        vm_regs[t->ctl] &= ~TAIFG;
+    }
+    else{
+        vm_regs[t->iv] = 0;
+    }
+}
+
+/*
+ * Echo edge on P2.1, captured by TA1.1 if it's set up for it
+ */
+static void vm_capture(uint8_t rising){
+    VM_Timer *t = &vm_timers[1];
+    uint16_t cctl = R(TA1CCTL1);
+    if(!t->running || !(cctl & CAP) || (cctl & CCIS_MASK) != CCIS_0 || !(R(P2SEL) & BIT1)
+       || !(cctl & (rising ? CM_1 : CM_2))){
+        return;
+    }
+    R(TA1CCR1) = (uint16_t)vm_timer_count(t, vm_now);
+    if(cctl & CCIFG){
+        R(TA1CCTL1) |= COV;
+    }
+    R(TA1CCTL1) |= CCIFG;
+}
+
+/*
+ * Starts an echo when the trigger falls after at least 10 us high. The round trip is worked out
+ * from the environment's depth and temperature.
+ */
+static void vm_ping(void){
+    double distance = (DEPTH_MOUNT_MM - vm_env(PKT_SEN_DEPTH)) / 1000.0;
+    double c = 331.3 + 0.606 * vm_env(PKT_SEN_TEMP);
+    double u = vm_uniform();
+    nrf_sampled();
+    if(u < VM_ECHO_MISS){
+        vm_account();
+        vm_ranging = 0;                 // Counted as idle, the firmware's timeout isn't known here
+        return;
+    }
+    if(distance < 0.02){
+        distance = 0.02;
+    }
+    if(u < VM_ECHO_MISS + VM_ECHO_STRAY){
+        distance *= 0.2 + 0.7 * vm_uniform();
+    }
+    vm_echo_rise = vm_now + VM_ECHO_DELAY;
+    vm_echo_fall = vm_echo_rise + (VM_Time)(2.0 * distance / c * VM_HZ);
+    vm_dirty = 1;
+}
+
+static void vm_pins(void){
+    uint8_t csn = (R(P1DIR) & BIT5) ? ((R(P1OUT) & BIT5) != 0) : 1;
+    uint8_t ce = (R(P2DIR) & BIT3) && (R(P2OUT) & BIT3);
+    uint8_t trigger = (R(P2DIR) & BIT0) && (R(P2OUT) & BIT0);
+    if(trigger && !vm_trigger){
+        vm_trigger_rise = vm_now;
+        vm_account();
+        vm_ranging = 1;
+    }
+    else if(!trigger && vm_trigger && vm_now - vm_trigger_rise >= VM_US(10) && vm_echo_fall == VM_NEVER){
+        vm_ping();
+    }
+    vm_trigger = trigger;
+    if(csn != vm_csn){
+        vm_csn = csn;
+        nrf_csn(csn);
+    }
+    if(ce != vm_ce){
+        vm_ce = ce;
+        nrf_ce(ce);
+    }
+}
+
+/*
+ * USCI SPI master
+ */
+static VM_Time vm_usci_bit(VM_Usci *u){
+    uint16_t br = vm_regs[u->br0] | (vm_regs[u->br1] << 8);
+    return (br ? br : 1) * vm_cycle;
+}
+
+static void vm_usci_tx(VM_Usci *u){
+    if(vm_regs[u->ctl1] & UCSWRST){
+        return;
+    }
+    R(IFG2) &= ~u->txifg;
+    u->next = (uint8_t)vm_regs[u->txbuf];
+    u->queued = 1;
+    vm_regs[u->stat] |= UCBUSY;
+    if(!u->shifting && u->load == VM_NEVER){
+        u->load = vm_now + vm_usci_bit(u);      // Moves to the shift register on the next bit clock
+    }
+}
+
+static void vm_usci_reset(VM_Usci *u){
+    if(vm_regs[u->ctl1] & UCSWRST){
+        u->queued = u->shifting = 0;
+        u->load = u->done = VM_NEVER;
+        vm_regs[u->stat] &= ~(UCBUSY | UCOE);
+        R(IFG2) = (R(IFG2) & ~u->rxifg) | u->txifg;
+        R(IE2) &= ~(u->rxifg | u->txifg);       // Same bit positions as the flags
+    }
+}
+
+static void vm_usci_events(VM_Usci *u, uint8_t slave){
+    uint8_t miso;
+    if(u->done <= vm_now){
+        miso = slave ? nrf_exchange(u->shift) : 0xFF;
+        vm_regs[u->rxbuf] = miso;
+        if(R(IFG2) & u->rxifg){
+            vm_regs[u->stat] |= UCOE;
+        }
+        R(IFG2) |= u->rxifg;
+        u->shifting = 0;
+        u->done = VM_NEVER;
+        if(u->queued){
+            u->load = vm_now;
+        }
+        else{
+            vm_regs[u->stat] &= ~UCBUSY;
+        }
+    }
+    if(u->load <= vm_now){
+        u->shift = u->next;
+        u->queued = 0;
+        u->shifting = 1;
+        u->done = u->load + 8 * vm_usci_bit(u);
+        u->load = VM_NEVER;
+        R(IFG2) |= u->txifg;
+    }
+}
+
+/*
+ * ADC10
+ */
+static void vm_adc_convert(void){
+    uint16_t ctl0 = R(ADC10CTL0), ctl1 = R(ADC10CTL1);
+    static const uint8_t sht[4] = {4, 8, 16, 64};
+    VM_Time clk;
+
+    switch((ctl1 >> 3) & 3){
+        case 0: clk = VM_ADC10OSC_TICK; break;
+        case 1: clk = VM_ACLK_TICK; break;
+        default: clk = vm_cycle; break;
+    }
+    if(vm_adc_ch == 10){
+        nrf_sampled();
+    }
+    vm_account();
+    vm_adc_busy = 1;
+    vm_adc_done = vm_now + (sht[(ctl0 & ADC10SHT_MASK) >> 11] + 13) * ((((ctl1 & ADC10DIV_MASK) >> 5) + 1) * clk);
+}
+
+static void vm_adc_start(void){
+    uint16_t ctl0 = R(ADC10CTL0);
+
+    R(ADC10CTL0) &= ~ADC10SC;
+    if(!(ctl0 & ENC) && !vm_adc_busy){
+        vm_adc_ch = -1;                 // Ends a sequence, one converting finishes first
+    }
+    if(!(ctl0 & ADC10SC) || !(ctl0 & ENC) || !(ctl0 & ADC10ON) || vm_adc_busy){
+        return;
+    }
+    if(vm_adc_ch < 0){
+        vm_adc_ch = R(ADC10CTL1) >> 12;
+    }
+    vm_adc_convert();
+}
+
+/*
+ * Writing ADC10SA starts a block of ADC10DTC1 transfers
+ */
+static void vm_dtc_start(void){
+    vm_dtc_left = R(ADC10DTC1);
+    vm_dtc_addr = R(ADC10SA);
+}
+
+/*
+ * Finishes a conversion, hands it to the DTC if a block is going, and starts the next in a sequence.
+ * Without MSC the next waits for another ADC10SC.
+ */
+static void vm_adc_events(void){
+    uint16_t ctl1 = R(ADC10CTL1), conseq = ctl1 & CONSEQ_MASK, at;
+    double raw = 512;
+    int16_t code;
+    if(vm_adc_done > vm_now){
+        return;
+    }
+    vm_account();
+    vm_adc_busy = 0;
+    vm_adc_done = VM_NEVER;
+    if(vm_adc_ch == 10){                // 3.55 mV/C, 986 mV at 0 C, against the 2.5 V reference
+        raw = (986.0 + 3.55 * vm_env(PKT_SEN_TEMP)) / 2500.0 * 1024.0;
+    }
+    code = (int16_t)floor(raw + vm_uniform());   // Dithered to the nearest code
+    code = (code < 0) ? 0 : (code > 1023) ? 1023 : code;
+    R(ADC10MEM) = (ctl1 & ADC10DF) ? (uint16_t)((code - 512) << 6) : (uint16_t)code;
+    if(vm_dtc_left > 0){
+        at = vm_dtc_addr - VM_RAM;
+        if(vm_dtc_addr >= VM_RAM && at + 1 < VM_RAM_SIZE){
+            vm_ram[at] = R(ADC10MEM) & 0xFF;
+            vm_ram[at + 1] = R(ADC10MEM) >> 8;
+        }
+        vm_dtc_addr += 2;
+        if(--vm_dtc_left == 0){
+            R(ADC10CTL0) |= ADC10IFG;   // The DTC only flags the end of its block
+        }
+    }
+    else{
+        R(ADC10CTL0) |= ADC10IFG;
+    }
+    if(conseq == 0 || !(R(ADC10CTL0) & ENC) || vm_adc_ch < 0){
+        vm_adc_ch = -1;
+        return;
+    }
+    if(conseq & CONSEQ0){               // Sequences count down to A0
+        if(vm_adc_ch > 0){
+            vm_adc_ch--;
+        }
+        else if(conseq == (CONSEQ0 | CONSEQ1)){
+            vm_adc_ch = ctl1 >> 12;
+        }
+        else{
+            vm_adc_ch = -1;
+            return;
+        }
+    }
+    if(R(ADC10CTL0) & MSC){
+        vm_adc_convert();
+    }
+}
+
+/*
+ * Events
+ */
+static VM_Time vm_next_event(void){
+    VM_Time next = nrf_next_event(), at;
+    uint8_t i;
+    for(i=0; i<2; i++){
+        if((at = vm_timer_next(&vm_timers[i])) < next){
+            next = at;
+        }
+        if(vm_usci[i].load < next){
+            next = vm_usci[i].load;
+        }
+        if(vm_usci[i].done < next){
+            next = vm_usci[i].done;
+        }
+    }
+    if(vm_adc_done < next){
+        next = vm_adc_done;
+    }
+    if(vm_echo_rise < next){
+        next = vm_echo_rise;
+    }
+    if(vm_echo_fall < next){
+        next = vm_echo_fall;
+    }
+    return next;
+}
+
+static void vm_events(void){
+    uint8_t i;
+    for(i=0; i<2; i++){
+        vm_timer_events(&vm_timers[i]);
+        vm_usci_events(&vm_usci[i], i == 1);
+    }
+    vm_adc_events();
+    if(vm_echo_rise <= vm_now){
+        vm_echo_rise = VM_NEVER;
+        R(P2IN) |= BIT1;
+        vm_capture(1);
+    }
+    if(vm_echo_fall <= vm_now){
+        vm_echo_fall = VM_NEVER;
+        vm_account();
+        vm_ranging = 0;
+        R(P2IN) &= ~BIT1;
+        vm_capture(0);
+    }
+    if(nrf_next_event() <= vm_now){
+        nrf_event();
+    }
+    vm_dirty = 1;
+}
+
+/*
+ * Interrupts, highest priority first. Single source flags are cleared when the ISR is taken.
+ */
+static void (*vm_pending_isr(void))(void){
+    uint8_t usci = R(IFG2) & R(IE2);
+    if((R(TA1CCTL0) & (CCIE | CCIFG)) == (CCIE | CCIFG)){
+        R(TA1CCTL0) &= ~CCIFG;
+        return TIMER1_A0_ISR;
+    }
+    if((R(TA1CCTL1) & (CCIE | CCIFG)) == (CCIE | CCIFG) || (R(TA1CTL) & (TAIE | TAIFG)) == (TAIE | TAIFG)){
+        return TIMER1_A1_ISR;
+    }
+    if((R(TA0CCTL0) & (CCIE | CCIFG)) == (CCIE | CCIFG)){
+        R(TA0CCTL0) &= ~CCIFG;
+        return TIMER0_A0_ISR;
+    }
+    if((R(TA0CCTL1) & (CCIE | CCIFG)) == (CCIE | CCIFG) || (R(TA0CTL) & (TAIE | TAIFG)) == (TAIE | TAIFG)){
+        return TIMER0_A1_ISR;
+    }
+    if(usci & (UCA0RXIFG | UCB0RXIFG)){
+        return USCIAB0RX_ISR;
+    }
+    if(usci & (UCA0TXIFG | UCB0TXIFG)){
+        return USCIAB0TX_ISR;
+    }
+    if((R(ADC10CTL0) & (ADC10IE | ADC10IFG)) == (ADC10IE | ADC10IFG)){
+        R(ADC10CTL0) &= ~ADC10IFG;
+        return ADC10_ISR;
+    }
+    return NULL;
+}
+
+static void vm_flush(void);
+
+static void vm_interrupts(void){
+    void (*isr)(void);
+    while((vm_sr & GIE) && !vm_in_isr && (isr = vm_pending_isr()) != NULL){
+        vm_account();
+        vm_isr_sr = vm_sr;
+        vm_sr = 0;                      // Wakes the CPU and masks interrupts
+        vm_in_isr = 1;
+        vm_node.interrupts++;
+        vm_advance(vm_now + 6 * vm_cycle);
+        isr();
+        vm_flush();
+        vm_advance(vm_now + 5 * vm_cycle);  // RETI
+        vm_account();
+        vm_sr = vm_isr_sr;
+        vm_in_isr = 0;
+    }
+}
+
+/*
+ * Moves time on to target, handling events and interrupts along the way. Yields when it gets to the
+ * simulator's until.
+ */
+static void vm_advance(VM_Time target){
+    VM_Time stop;
+    for(;;){
+        vm_interrupts();
+        if(vm_now >= target){
+            return;
+        }
+        if(vm_dirty){
+            vm_next = vm_next_event();
+            vm_dirty = 0;
+        }
+        stop = (vm_next < target) ? vm_next : target;
+        if(stop < vm_now){
+            stop = vm_now;
+        }
+        if(stop > vm_node.until){
+            vm_now = (vm_now > vm_node.until) ? vm_now : vm_node.until;
+            vm_yield(VM_PAUSED);
+            continue;
+        }
+        vm_now = stop;
+        if(vm_now >= vm_next){
+            vm_events();
+        }
+    }
+}
+
+/*
+ * Sleeps from one event to the next until an ISR clears CPUOFF
+ */
+static void vm_sleep(void){
+    while(vm_sr & CPUOFF){
+        vm_interrupts();
+        if(!(vm_sr & CPUOFF)){
+            break;
+        }
+        if(vm_dirty){
+            vm_next = vm_next_event();
+            vm_dirty = 0;
+        }
+        if(vm_next == VM_NEVER){
+            vm_halt((vm_sr & GIE) ? "asleep with nothing to wake it" : "asleep with interrupts disabled");
+        }
+        vm_advance((vm_next > vm_now) ? vm_next : vm_now + vm_cycle);
+    }
+}
+
+/*
+ * Registers
+ */
+static void vm_read(VM_Reg reg){
+    switch(reg){
+        case VM_TA0R: R(TA0R) = (uint16_t)vm_timer_count(&vm_timers[0], vm_now); break;
+        case VM_TA1R: R(TA1R) = (uint16_t)vm_timer_count(&vm_timers[1], vm_now); break;
+        case VM_TA0IV: vm_timer_iv(&vm_timers[0]); break;
+        case VM_TA1IV: vm_timer_iv(&vm_timers[1]); break;
+        case VM_UCA0RXBUF: R(IFG2) &= ~UCA0RXIFG; R(UCA0STAT) &= ~UCOE; break;
+        case VM_UCB0RXBUF: R(IFG2) &= ~UCB0RXIFG; R(UCB0STAT) &= ~UCOE; break;
+        default: break;
+    }
+}
+
+static void vm_written(VM_Reg reg){
+    VM_Timer *t;
+    switch(reg){
+        case VM_BCSCTL1:
+            vm_account();
+            vm_mhz = (R(BCSCTL1) == VM_CAL_16MHZ) ? 16 : (R(BCSCTL1) == VM_CAL_12MHZ) ? 12
+                     : (R(BCSCTL1) == VM_CAL_8MHZ) ? 8 : 1;
+            vm_cycle = VM_HZ / (vm_mhz * 1000000ULL);
+            break;
+        case VM_WDTCTL:
+            if((R(WDTCTL) & 0xFF00) != WDTPW){
+                vm_halt("watchdog reset");
+            }
+            break;
+        case VM_P1OUT: case VM_P1DIR: case VM_P2OUT: case VM_P2DIR:
+            vm_pins();
+            break;
+        case VM_UCA0CTL1: vm_usci_reset(&vm_usci[0]); break;
+        case VM_UCB0CTL1: vm_usci_reset(&vm_usci[1]); break;
+        case VM_UCA0TXBUF: vm_usci_tx(&vm_usci[0]); break;
+        case VM_UCB0TXBUF: vm_usci_tx(&vm_usci[1]); break;
+        case VM_TA0CTL: vm_timer_ctl(&vm_timers[0]); break;
+        case VM_TA1CTL: vm_timer_ctl(&vm_timers[1]); break;
+        case VM_TA0CCTL0: case VM_TA0CCR0: case VM_TA1CCTL0: case VM_TA1CCR0:
+            t = &vm_timers[reg >= VM_TA1CTL];
+            t->ccr0_after = vm_now;
+            break;
+        case VM_TA0CCTL1: case VM_TA0CCR1: case VM_TA1CCTL1: case VM_TA1CCR1:
+            t = &vm_timers[reg >= VM_TA1CTL];
+            t->ccr1_after = vm_now;
+            break;
+        case VM_ADC10CTL0:
+            vm_adc_start();
+            break;
+        case VM_ADC10SA:
+            vm_dtc_start();
+            break;
+        default:
+            break;
+    }
+    vm_dirty = 1;
+}
+
+/*
+ * Code. The firmware is built with -fsanitize-coverage=trace-pc, so every basic block starts with a
+ * call here, and sim/blocks.awk left what each one costs in the vm_blocks section, keyed by where
+ * the call returns to. The cost is owed until the next register access or intrinsic.
+ */
+typedef struct VM_BlockStruct{
+    uintptr_t pc;
+    uintptr_t cycles;
+} VM_Block;
+
+extern VM_Block __start_vm_blocks[] __attribute__((weak, visibility("hidden")));
+extern VM_Block __stop_vm_blocks[] __attribute__((weak, visibility("hidden")));
+
+static int vm_block_cmp(const void *a, const void *b){
+    uintptr_t x = ((const VM_Block *)a)->pc, y = ((const VM_Block *)b)->pc;
+    return (x > y) - (x < y);
+}
+
+void __sanitizer_cov_trace_pc(void){
+    static const VM_Block *seen[VM_BLOCK_CACHE];    // Blocks run lately, by their address
+    uintptr_t pc = (uintptr_t)__builtin_return_address(0);
+    const VM_Block **hit = &seen[(pc >> 2) % VM_BLOCK_CACHE];
+    VM_Block *lo = __start_vm_blocks, *hi = __stop_vm_blocks, *mid;
+    if(*hit != NULL && (*hit)->pc == pc){
+        vm_owed += (*hit)->cycles;
+        return;
+    }
+    while(lo < hi){
+        mid = lo + (hi - lo) / 2;
+        if(mid->pc < pc){
+            lo = mid + 1;
+        }
+        else{
+            hi = mid;
+        }
+    }
+    if(lo < __stop_vm_blocks && lo->pc == pc){
+        vm_owed += lo->cycles;
+        *hit = lo;
+    }
+}
+
+/*
+ * Acts on the last register written, then moves time on over the code run since
+ */
+static void vm_flush(void){
+    int reg = vm_pending;
+    VM_Time owed = vm_owed;
+    if(reg >= 0){
+        vm_pending = -1;
+        vm_written((VM_Reg)reg);
+    }
+    if(owed != 0){
+        vm_owed = 0;
+        vm_advance(vm_now + owed * vm_cycle);
+    }
+}
+
+void vm_settle(void){
+    vm_flush();
+}
+
+/*
+ * Every register access acts on the last one, costs VM_ACCESS_CYCLES, and may be a write
+ */
+static void vm_access(VM_Reg reg){
+    vm_flush();
+    vm_node.accesses++;
+    vm_advance(vm_now + VM_ACCESS_CYCLES * vm_cycle);
+    if(vm_hooks[reg] & VM_ON_READ){
+        vm_read(reg);
+    }
+    if(vm_hooks[reg] & VM_ON_WRITE){
+        vm_pending = reg;
+    }
+}
+
+volatile uint8_t *vm_reg8(VM_Reg reg){
+    vm_access(reg);
+    return (volatile uint8_t *)&vm_regs[reg];
+}
+
+volatile uint16_t *vm_reg16(VM_Reg reg){
+    vm_access(reg);
+    return &vm_regs[reg];
+}
+
+/*
+ * Intrinsics
+ */
+void __bis_SR_register(unsigned short bits){
+    vm_flush();
+    vm_advance(vm_now + vm_cycle);
+    vm_account();
+    vm_sr |= bits;
+    vm_sleep();
+}
+
+void __bic_SR_register(unsigned short bits){
+    vm_flush();
+    vm_advance(vm_now + vm_cycle);
+    vm_account();
+    vm_sr &= ~bits;
+}
+
+void __bic_SR_register_on_exit(unsigned short bits){
+    if(vm_in_isr){
+        vm_isr_sr &= ~bits;
+    }
+    else{
+        vm_sr &= ~bits;
+    }
+}
+
+void __enable_interrupt(void){
+    vm_flush();
+    vm_sr |= GIE;
+    vm_advance(vm_now + vm_cycle);
+}
+
+void __disable_interrupt(void){
+    vm_flush();
+    vm_advance(vm_now + vm_cycle);
+    vm_sr &= ~GIE;
+}
+
+__istate_t __get_interrupt_state(void){
+    vm_flush();
+    vm_advance(vm_now + vm_cycle);
+    return vm_sr & GIE;
+}
+
+void __set_interrupt_state(__istate_t state){
+    vm_flush();
+    vm_sr = (vm_sr & ~GIE) | (state & GIE);
+    vm_advance(vm_now + vm_cycle);
+}
+
+void __delay_cycles(unsigned long cycles){
+    vm_flush();
+    vm_advance(vm_now + cycles * vm_cycle);
+}
+
+void __no_operation(void){
+    vm_flush();
+    vm_advance(vm_now + vm_cycle);
+}
+
+/*
+ * Entry points for the simulator. vm_node is filled in first.
+ */
+int vm_start(void){
+    uint8_t i;
+    static const VM_Reg written[] = {
+        VM_BCSCTL1, VM_WDTCTL, VM_P1OUT, VM_P1DIR, VM_P2OUT, VM_P2DIR, VM_UCA0CTL1, VM_UCB0CTL1,
+        VM_UCA0TXBUF, VM_UCB0TXBUF, VM_TA0CTL, VM_TA1CTL, VM_TA0CCTL0, VM_TA0CCR0, VM_TA1CCTL0,
+        VM_TA1CCR0, VM_TA0CCTL1, VM_TA0CCR1, VM_TA1CCTL1, VM_TA1CCR1, VM_ADC10CTL0, VM_ADC10SA
+    };
+    static const VM_Reg read[] = {
+        VM_TA0R, VM_TA1R, VM_TA0IV, VM_TA1IV, VM_UCA0RXBUF, VM_UCB0RXBUF
+    };
+
+    for(i=0; i<sizeof(written)/sizeof(written[0]); i++){
+        vm_hooks[written[i]] |= VM_ON_WRITE;
+    }
+    for(i=0; i<sizeof(read)/sizeof(read[0]); i++){
+        vm_hooks[read[i]] |= VM_ON_READ;
+    }
+    R(CALBC1_1MHZ) = VM_CAL_1MHZ;
+    R(CALBC1_8MHZ) = VM_CAL_8MHZ;
+    R(CALBC1_12MHZ) = VM_CAL_12MHZ;
+    R(CALBC1_16MHZ) = VM_CAL_16MHZ;
+    R(BCSCTL1) = 0x87;                  // PUC values
+    R(DCOCTL) = 0x60;
+    R(WDTCTL) = 0x6900;
+    R(UCA0CTL1) = UCSWRST;
+    R(UCB0CTL1) = UCSWRST;
+    R(IFG2) = UCA0TXIFG | UCB0TXIFG;
+    R(P2SEL) = BIT6 | BIT7;
+    for(i=0; i<2; i++){
+        vm_timers[i].tick = VM_ACLK_TICK;
+        vm_usci[i].load = vm_usci[i].done = VM_NEVER;
+    }
+
+    if(__stop_vm_blocks - __start_vm_blocks > 0){  // Linked in file order, and a file's code isn't all in .text
+        qsort(__start_vm_blocks, __stop_vm_blocks - __start_vm_blocks, sizeof(VM_Block), vm_block_cmp);
+    }
+    flash_mem_reset();                  // Erased
+    vm_rng = vm_node.seed;
+    vm_now = vm_accounted = vm_node.boot;
+    vm_node.now = vm_now;
+    vm_node_id = vm_node.id;
+    vm_node.ua = pwr_ua;
+    vm_node.status = VM_PAUSED;
+    nrf_reset();
+    if((vm_stack = malloc(VM_STACK_SIZE)) == NULL || getcontext(&vm_self) != 0){
+        return -1;
+    }
+    vm_self.uc_stack.ss_sp = vm_stack;
+    vm_self.uc_stack.ss_size = VM_STACK_SIZE;
+    vm_self.uc_link = NULL;
+    makecontext(&vm_self, vm_entry, 0);
+    return 0;
+}
+
+/*
+ * Runs the node until it yields
+ */
+void vm_resume(void){
+    vm_node.status = VM_RUNNING;
+    swapcontext(&vm_host, &vm_self);
+}
@@ -0,0 +1,259 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Stand-in for TI's msp430g2553.h used when the node firmware is built into a virtual node for the
+ * network simulator (see vm.h). Every peripheral register the firmware uses is an lvalue that goes
+ * through vm_reg8()/vm_reg16(), so each access is a point where the virtual G2553 catches its clocks,
+ * timers, USCI, ADC10, and the radio up and takes interrupts. Bit names and values are TI's.
+ *
+ * Only what the firmware in this repo touches is here. Registers are 16 bits wide like on the part,
+ * but int is still 32 bits on the host.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+
+#ifndef MSP430G2553_H_
+#define MSP430G2553_H_
+
+// Registers, in no particular order
+typedef enum VM_RegEnum{
+    VM_DCOCTL, VM_BCSCTL1, VM_BCSCTL2, VM_BCSCTL3,
+    VM_CALBC1_1MHZ, VM_CALDCO_1MHZ, VM_CALBC1_8MHZ, VM_CALDCO_8MHZ,
+    VM_CALBC1_12MHZ, VM_CALDCO_12MHZ, VM_CALBC1_16MHZ, VM_CALDCO_16MHZ,
+    VM_P1IN, VM_P1OUT, VM_P1DIR, VM_P1SEL, VM_P1SEL2, VM_P1REN,
+    VM_P2IN, VM_P2OUT, VM_P2DIR, VM_P2SEL, VM_P2SEL2, VM_P2REN,
+    VM_IE2, VM_IFG2,
+    VM_UCA0CTL0, VM_UCA0CTL1, VM_UCA0BR0, VM_UCA0BR1, VM_UCA0MCTL, VM_UCA0STAT, VM_UCA0RXBUF, VM_UCA0TXBUF,
+    VM_UCB0CTL0, VM_UCB0CTL1, VM_UCB0BR0, VM_UCB0BR1, VM_UCB0STAT, VM_UCB0RXBUF, VM_UCB0TXBUF,
+    VM_WDTCTL,
+    VM_TA0CTL, VM_TA0R, VM_TA0CCTL0, VM_TA0CCR0, VM_TA0CCTL1, VM_TA0CCR1, VM_TA0IV,
+    VM_TA1CTL, VM_TA1R, VM_TA1CCTL0, VM_TA1CCR0, VM_TA1CCTL1, VM_TA1CCR1, VM_TA1IV,
+    VM_ADC10CTL0, VM_ADC10CTL1, VM_ADC10AE0, VM_ADC10DTC0, VM_ADC10DTC1, VM_ADC10SA, VM_ADC10MEM,
+    VM_FCTL1, VM_FCTL2, VM_FCTL3,
+    VM_NUM_REGS
+} VM_Reg;
+
+volatile uint8_t *vm_reg8(VM_Reg reg);
+volatile uint16_t *vm_reg16(VM_Reg reg);
+
+#define DCOCTL          (*vm_reg8(VM_DCOCTL))
+#define BCSCTL1         (*vm_reg8(VM_BCSCTL1))
+#define BCSCTL2         (*vm_reg8(VM_BCSCTL2))
+#define BCSCTL3         (*vm_reg8(VM_BCSCTL3))
+#define CALBC1_1MHZ     (*vm_reg8(VM_CALBC1_1MHZ))
+#define CALDCO_1MHZ     (*vm_reg8(VM_CALDCO_1MHZ))
+#define CALBC1_8MHZ     (*vm_reg8(VM_CALBC1_8MHZ))
+#define CALDCO_8MHZ     (*vm_reg8(VM_CALDCO_8MHZ))
+#define CALBC1_12MHZ    (*vm_reg8(VM_CALBC1_12MHZ))
+#define CALDCO_12MHZ    (*vm_reg8(VM_CALDCO_12MHZ))
+#define CALBC1_16MHZ    (*vm_reg8(VM_CALBC1_16MHZ))
+#define CALDCO_16MHZ    (*vm_reg8(VM_CALDCO_16MHZ))
+#define P1IN            (*vm_reg8(VM_P1IN))
+#define P1OUT           (*vm_reg8(VM_P1OUT))
+#define P1DIR           (*vm_reg8(VM_P1DIR))
+#define P1SEL           (*vm_reg8(VM_P1SEL))
+#define P1SEL2          (*vm_reg8(VM_P1SEL2))
+#define P1REN           (*vm_reg8(VM_P1REN))
+#define P2IN            (*vm_reg8(VM_P2IN))
+#define P2OUT           (*vm_reg8(VM_P2OUT))
+#define P2DIR           (*vm_reg8(VM_P2DIR))
+#define P2SEL           (*vm_reg8(VM_P2SEL))
+#define P2SEL2          (*vm_reg8(VM_P2SEL2))
+#define P2REN           (*vm_reg8(VM_P2REN))
+#define IE2             (*vm_reg8(VM_IE2))
+#define IFG2            (*vm_reg8(VM_IFG2))
+#define UCA0CTL0        (*vm_reg8(VM_UCA0CTL0))
+#define UCA0CTL1        (*vm_reg8(VM_UCA0CTL1))
+#define UCA0BR0         (*vm_reg8(VM_UCA0BR0))
+#define UCA0BR1         (*vm_reg8(VM_UCA0BR1))
+#define UCA0MCTL        (*vm_reg8(VM_UCA0MCTL))
+#define UCA0STAT        (*vm_reg8(VM_UCA0STAT))
+#define UCA0RXBUF       (*vm_reg8(VM_UCA0RXBUF))
+#define UCA0TXBUF       (*vm_reg8(VM_UCA0TXBUF))
+#define UCB0CTL0        (*vm_reg8(VM_UCB0CTL0))
+#define UCB0CTL1        (*vm_reg8(VM_UCB0CTL1))
+#define UCB0BR0         (*vm_reg8(VM_UCB0BR0))
+#define UCB0BR1         (*vm_reg8(VM_UCB0BR1))
+#define UCB0STAT        (*vm_reg8(VM_UCB0STAT))
+#define UCB0RXBUF       (*vm_reg8(VM_UCB0RXBUF))
+#define UCB0TXBUF       (*vm_reg8(VM_UCB0TXBUF))
+#define WDTCTL          (*vm_reg16(VM_WDTCTL))
+#define TA0CTL          (*vm_reg16(VM_TA0CTL))
+#define TA0R            (*vm_reg16(VM_TA0R))
+#define TA0CCTL0        (*vm_reg16(VM_TA0CCTL0))
+#define TA0CCR0         (*vm_reg16(VM_TA0CCR0))
+#define TA0CCTL1        (*vm_reg16(VM_TA0CCTL1))
+#define TA0CCR1         (*vm_reg16(VM_TA0CCR1))
+#define TA0IV           (*vm_reg16(VM_TA0IV))
+#define TA1CTL          (*vm_reg16(VM_TA1CTL))
+#define TA1R            (*vm_reg16(VM_TA1R))
+#define TA1CCTL0        (*vm_reg16(VM_TA1CCTL0))
+#define TA1CCR0         (*vm_reg16(VM_TA1CCR0))
+#define TA1CCTL1        (*vm_reg16(VM_TA1CCTL1))
+#define TA1CCR1         (*vm_reg16(VM_TA1CCR1))
+#define TA1IV           (*vm_reg16(VM_TA1IV))
+#define ADC10CTL0       (*vm_reg16(VM_ADC10CTL0))
+#define ADC10CTL1       (*vm_reg16(VM_ADC10CTL1))
+#define ADC10AE0        (*vm_reg8(VM_ADC10AE0))
+#define ADC10DTC0       (*vm_reg8(VM_ADC10DTC0))
+#define ADC10DTC1       (*vm_reg8(VM_ADC10DTC1))
+#define ADC10SA         (*vm_reg16(VM_ADC10SA))
+#define ADC10MEM        (*vm_reg16(VM_ADC10MEM))
+#define FCTL1           (*vm_reg16(VM_FCTL1))
+#define FCTL2           (*vm_reg16(VM_FCTL2))
+#define FCTL3           (*vm_reg16(VM_FCTL3))
+
+// Port bits
+#define BIT0            (0x0001)
+#define BIT1            (0x0002)
+#define BIT2            (0x0004)
+#define BIT3            (0x0008)
+#define BIT4            (0x0010)
+#define BIT5            (0x0020)
+#define BIT6            (0x0040)
+#define BIT7            (0x0080)
+
+// Status register
+#define GIE             (0x0008)
+#define CPUOFF          (0x0010)
+#define OSCOFF          (0x0020)
+#define SCG0            (0x0040)
+#define SCG1            (0x0080)
+#define LPM0_bits       (CPUOFF)
+#define LPM3_bits       (SCG1+SCG0+CPUOFF)
+
+// Basic clock
+#define LFXT1S_2        (0x20)
+
+// Watchdog
+#define WDTPW           (0x5A00)
+#define WDTHOLD         (0x0080)
+
+// Timer_A
+#define TASSEL_1        (0x0100)        // ACLK
+#define TASSEL_2        (0x0200)        // SMCLK
+#define TASSEL_MASK     (0x0300)
+#define ID_3            (0x00C0)
+#define ID_MASK         (0x00C0)
+#define MC_0            (0x0000)
+#define MC_1            (0x0010)
+#define MC_2            (0x0020)
+#define MC_MASK         (0x0030)
+#define TACLR           (0x0004)
+#define TAIE            (0x0002)
+#define TAIFG           (0x0001)
+#define CM_1            (0x4000)
+#define CM_2            (0x8000)
+#define CM_3            (0xC000)
+#define CCIS_0          (0x0000)
+#define CCIS_MASK       (0x3000)
+#define SCS             (0x0800)
+#define CAP             (0x0100)
+#define CCIE            (0x0010)
+#define CCI             (0x0008)
+#define COV             (0x0002)
+#define CCIFG           (0x0001)
+#define TA0IV_TACCR1    (0x0002)
+#define TA0IV_TAIFG     (0x000A)
+#define TA1IV_TACCR1    (0x0002)
+#define TA1IV_TAIFG     (0x000A)
+
+// USCI
+#define UCCKPH          (0x80)
+#define UCCKPL          (0x40)
+#define UCMSB           (0x20)
+#define UCMST           (0x08)
+#define UCMODE_0        (0x00)
+#define UCMODE_2        (0x04)
+#define UCSYNC          (0x01)
+#define UCSSEL_2        (0x80)
+#define UCSSEL_3        (0xC0)
+#define UCSWRST         (0x01)
+#define UCOE            (0x20)
+#define UCBUSY          (0x01)
+#define UCA0RXIE        (0x01)
+#define UCA0TXIE        (0x02)
+#define UCB0RXIE        (0x04)
+#define UCB0TXIE        (0x08)
+#define UCA0RXIFG       (0x01)
+#define UCA0TXIFG       (0x02)
+#define UCB0RXIFG       (0x04)
+#define UCB0TXIFG       (0x08)
+
+// ADC10
+#define ADC10SC         (0x0001)
+#define ENC             (0x0002)
+#define ADC10IFG        (0x0004)
+#define ADC10IE         (0x0008)
+#define ADC10ON         (0x0010)
+#define REFON           (0x0020)
+#define REF2_5V         (0x0040)
+#define MSC             (0x0080)
+#define REFBURST        (0x0100)
+#define ADC10SHT_2      (0x1000)
+#define ADC10SHT_3      (0x1800)
+#define ADC10SHT_MASK   (0x1800)
+#define SREF_1          (0x2000)
+#define CONSEQ0         (0x0002)
+#define CONSEQ1         (0x0004)
+#define CONSEQ_MASK     (0x0006)
+#define ADC10DIV_3      (0x0060)
+#define ADC10DIV_MASK   (0x00E0)
+#define ADC10DF         (0x0200)
+#define INCH_0          (0x0000)
+#define INCH_1          (0x1000)
+#define INCH_2          (0x2000)
+#define INCH_3          (0x3000)
+#define INCH_4          (0x4000)
+#define INCH_5          (0x5000)
+#define INCH_6          (0x6000)
+#define INCH_7          (0x7000)
+#define INCH_10         (0xA000)
+
+// Flash controller
+#define FWKEY           (0xA500)
+#define FSSEL_1         (0x0040)
+#define ERASE           (0x0002)
+#define WRT             (0x0040)
+#define BUSY            (0x0001)
+#define LOCK            (0x0010)
+
+// Interrupt vectors, only used to name the ISRs
+#define ADC10_VECTOR        (5 * 2u)
+#define USCIAB0TX_VECTOR    (6 * 2u)
+#define USCIAB0RX_VECTOR    (7 * 2u)
+#define TIMER0_A1_VECTOR    (8 * 2u)
+#define TIMER0_A0_VECTOR    (9 * 2u)
+#define TIMER1_A1_VECTOR    (12 * 2u)
+#define TIMER1_A0_VECTOR    (13 * 2u)
+
+// ISRs are called by the virtual G2553 by name, see g2553.c
+#define interrupt(vector)   used
+#define __interrupt
+
+// Intrinsics
+typedef unsigned short __istate_t;
+
+void __bis_SR_register(unsigned short bits);
+void __bic_SR_register(unsigned short bits);
+void __bic_SR_register_on_exit(unsigned short bits);
+void __enable_interrupt(void);
+void __disable_interrupt(void);
+__istate_t __get_interrupt_state(void);
+void __set_interrupt_state(__istate_t state);
+void __delay_cycles(unsigned long cycles);
+void __no_operation(void);
+
+#define LPM0            __bis_SR_register(LPM0_bits)
+#define LPM3            __bis_SR_register(LPM3_bits)
+#define LPM0_EXIT       __bic_SR_register_on_exit(LPM0_bits)
+#define LPM3_EXIT       __bic_SR_register_on_exit(LPM3_bits)
+
+extern uint8_t vm_node_id;              // NODE_ID in main.c, set per node by the simulator
+
+#endif /* MSP430G2553_H_ */
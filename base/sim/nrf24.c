@@ -0,0 +1,327 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Virtual nRF24L01+ on USCI-B0 for the network simulator, see vm.h. Models the part radio.c drives:
+ * the register file, the 3 deep TX and RX FIFOs, the commands it sends, power down, standby, TX, and
+ * RX with the 130 us settling time, and the STATUS flags. Auto-ack, retransmits, and the hardware CRC
+ * are off in this firmware so they aren't here.
+ *
+ * Sent frames go in the node's outbox. Every span of time the receiver is on is recorded, and the
+ * simulator puts every frame it heard in one of those spans in the inbox. Frames move from the inbox
+ * to the RX FIFO when the firmware next pulls CSN low, the only time it could tell they had arrived.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "vm.h"
+
+#define NRF_SETTLE          VM_US(130)
+#define NRF_AIRTIME         (((1 + 5 + VM_FRAME_SIZE) * 8 + 9) * (VM_HZ / 2000000))    // Preamble, address, payload, PCF at 2 Mbps
+#define NRF_FIFO            3
+#define NRF_SPAN_KEEP       VM_US(1000)         // Spans are kept this long after they end
+
+// Commands, registers, and bits
+#define NRF_R_REGISTER      0x00
+#define NRF_W_REGISTER      0x20
+#define NRF_R_RX_PAYLOAD    0x61
+#define NRF_W_TX_PAYLOAD    0xA0
+#define NRF_FLUSH_TX        0xE1
+#define NRF_FLUSH_RX        0xE2
+#define NRF_CONFIG          0x00
+#define NRF_STATUS          0x07
+#define NRF_PRIM_RX         0x01
+#define NRF_PWR_UP          0x02
+#define NRF_FLAGS           0x70        // RX_DR, TX_DS, MAX_RT
+#define NRF_TX_DS           0x20
+#define NRF_RX_DR           0x40
+
+typedef enum NRF_ModeEnum{
+    NRF_OFF,
+    NRF_STANDBY,
+    NRF_TX,
+    NRF_RX
+} NRF_Mode;
+
+static uint8_t nrf_reg[0x20];
+static uint8_t nrf_flags;
+static uint8_t nrf_csn_level = 1;
+static uint8_t nrf_ce_level = 0;
+static uint8_t nrf_cmd, nrf_pos;        // Command being clocked in and bytes so far
+static uint8_t nrf_load[VM_FRAME_SIZE], nrf_nload;
+static uint8_t nrf_tx[NRF_FIFO][VM_FRAME_SIZE];
+static VM_Time nrf_tx_sampled[NRF_FIFO];
+static uint8_t nrf_ntx;
+static uint8_t nrf_rx[NRF_FIFO][VM_FRAME_SIZE];
+static uint8_t nrf_nrx;
+static NRF_Mode nrf_mode = NRF_OFF;
+static VM_Time nrf_tx_end = VM_NEVER;
+static VM_Time nrf_first_sample = VM_NEVER;     // First sensor reading since the last payload
+
+void nrf_reset(void){
+    memset(nrf_reg, 0, sizeof(nrf_reg));
+    nrf_reg[0x00] = 0x08;               // CONFIG
+    nrf_reg[0x01] = 0x3F;               // EN_AA
+    nrf_reg[0x02] = 0x03;               // EN_RXADDR
+    nrf_reg[0x03] = 0x03;               // SETUP_AW
+    nrf_reg[0x04] = 0x03;               // SETUP_RETR
+    nrf_reg[0x05] = 0x02;               // RF_CH
+    nrf_reg[0x06] = 0x0F;               // RF_SETUP
+    nrf_flags = 0;
+    nrf_ntx = nrf_nrx = 0;
+    nrf_mode = NRF_OFF;
+    nrf_tx_end = VM_NEVER;
+}
+
+static uint8_t nrf_status(void){
+    return nrf_flags | (nrf_nrx ? 0x00 : 0x0E) | (nrf_ntx == NRF_FIFO);
+}
+
+PWR_State nrf_state(void){
+    switch(nrf_mode){
+        case NRF_STANDBY: return PWR_RADIO_STBY;
+        case NRF_TX: return PWR_RADIO_TX;
+        case NRF_RX: return PWR_RADIO_RX;
+        default: return PWR_RADIO_PD;
+    }
+}
+
+void nrf_sampled(void){
+    if(nrf_first_sample == VM_NEVER){
+        nrf_first_sample = vm_now;
+    }
+}
+
+/*
+ * Puts the payload at the head of the TX FIFO on the air
+ */
+static void nrf_send(void){
+    VM_Frame *f;
+    if(vm_node.nout == VM_OUTBOX){
+        vm_block();                     // Simulator empties it
+    }
+    f = &vm_node.outbox[vm_node.nout++];
+    f->start = vm_now + NRF_SETTLE;
+    f->end = f->start + NRF_AIRTIME;
+    f->sampled = nrf_tx_sampled[0];
+    memcpy(f->data, nrf_tx[0], VM_FRAME_SIZE);
+    nrf_tx_end = f->end;
+}
+
+/*
+ * Works out the mode from CONFIG, CE, and the TX FIFO, recording receive spans as it goes
+ */
+static void nrf_update(void){
+    NRF_Mode mode;
+    VM_Span *s;
+    uint8_t send = 0;
+
+    if(!(nrf_reg[NRF_CONFIG] & NRF_PWR_UP)){
+        mode = NRF_OFF;
+        nrf_tx_end = VM_NEVER;
+    }
+    else if(nrf_tx_end != VM_NEVER){
+        mode = NRF_TX;                  // Finishes the packet even if CE dropped
+    }
+    else if(nrf_ce_level && (nrf_reg[NRF_CONFIG] & NRF_PRIM_RX)){
+        mode = NRF_RX;
+    }
+    else if(nrf_ce_level && nrf_ntx > 0){
+        mode = NRF_TX;
+        send = 1;
+    }
+    else{
+        mode = NRF_STANDBY;
+    }
+    if(mode == nrf_mode && !send){
+        return;
+    }
+    vm_account();
+    if(nrf_mode == NRF_RX && mode != NRF_RX && vm_node.nrx > 0){
+        s = &vm_node.rx[vm_node.nrx - 1];
+        if(s->start >= vm_now){
+            vm_node.nrx--;              // Never settled
+        }
+        else{
+            s->end = vm_now;
+        }
+    }
+    if(mode == NRF_RX && nrf_mode != NRF_RX){
+        if(vm_node.nrx == VM_RX_SPANS){
+            memmove(&vm_node.rx[0], &vm_node.rx[1], (VM_RX_SPANS - 1) * sizeof(VM_Span));
+            vm_node.nrx--;
+        }
+        vm_node.rx[vm_node.nrx++] = (VM_Span){vm_now + NRF_SETTLE, VM_NEVER};
+    }
+    nrf_mode = mode;
+    if(send){
+        nrf_send();
+    }
+    vm_changed();
+}
+
+void nrf_ce(uint8_t level){
+    nrf_ce_level = level;
+    nrf_update();
+}
+
+VM_Time nrf_next_event(void){
+    return nrf_tx_end;
+}
+
+void nrf_event(void){
+    if(nrf_tx_end > vm_now){
+        return;
+    }
+    vm_account();
+    nrf_tx_end = VM_NEVER;
+    if(nrf_ntx > 0){
+        memmove(&nrf_tx[0], &nrf_tx[1], (NRF_FIFO - 1) * VM_FRAME_SIZE);
+        memmove(&nrf_tx_sampled[0], &nrf_tx_sampled[1], (NRF_FIFO - 1) * sizeof(VM_Time));
+        nrf_ntx--;
+    }
+    nrf_flags |= NRF_TX_DS;
+    nrf_update();
+}
+
+static int nrf_covered(const VM_Frame *f){
+    uint32_t i;
+    for(i=0; i<vm_node.nrx; i++){
+        if(vm_node.rx[i].start <= f->start && vm_node.rx[i].end >= f->end){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Moves frames that ended by now from the inbox to the RX FIFO, waiting for the simulator first if
+ * the receiver may have heard something it hasn't been told about yet
+ */
+static void nrf_hear(void){
+    VM_Frame *f;
+    uint32_t i, j;
+    for(i=0; i<vm_node.nrx; i++){
+        if(vm_node.rx[i].end > vm_node.heard){
+            vm_block();
+            break;
+        }
+    }
+    while(vm_node.in_head != vm_node.in_tail){
+        f = &vm_node.inbox[vm_node.in_head % VM_INBOX];
+        if(f->end > vm_now){
+            break;
+        }
+        if(nrf_covered(f)){
+            if(nrf_nrx < NRF_FIFO){
+                memcpy(nrf_rx[nrf_nrx++], f->data, VM_FRAME_SIZE);
+                nrf_flags |= NRF_RX_DR;
+                vm_node.rx_frames++;
+            }
+            else{
+                vm_node.rx_dropped++;
+            }
+        }
+        vm_node.in_head++;
+    }
+    for(i=j=0; i<vm_node.nrx; i++){     // Drop spans that can't cover anything still to come
+        if(vm_node.rx[i].end == VM_NEVER || vm_node.rx[i].end + NRF_SPAN_KEEP >= vm_now){
+            vm_node.rx[j++] = vm_node.rx[i];
+        }
+    }
+    vm_node.nrx = j;
+}
+
+static void nrf_write(uint8_t reg, uint8_t value){
+    if(reg == NRF_STATUS){
+        nrf_flags &= ~(value & NRF_FLAGS);      // Write 1 to clear
+        return;
+    }
+    nrf_reg[reg] = value;
+    if(reg == NRF_CONFIG){
+        nrf_update();
+    }
+}
+
+/*
+ * CSN edges frame commands. Payload commands take effect when CSN goes back high.
+ */
+void nrf_csn(uint8_t level){
+    if(level == nrf_csn_level){
+        return;
+    }
+    nrf_csn_level = level;
+    if(!level){
+        nrf_hear();
+        nrf_pos = 0;
+        return;
+    }
+    if(nrf_pos == 0){
+        return;
+    }
+    switch(nrf_cmd){
+        case NRF_W_TX_PAYLOAD:
+            if(nrf_pos > 1 && nrf_ntx < NRF_FIFO){
+                memset(nrf_tx[nrf_ntx], 0, VM_FRAME_SIZE);
+                memcpy(nrf_tx[nrf_ntx], nrf_load, nrf_nload);
+                nrf_tx_sampled[nrf_ntx] = nrf_first_sample;
+                nrf_first_sample = VM_NEVER;
+                nrf_ntx++;
+                nrf_update();
+            }
+            break;
+        case NRF_R_RX_PAYLOAD:
+            if(nrf_pos > 1 && nrf_nrx > 0){
+                memmove(&nrf_rx[0], &nrf_rx[1], (NRF_FIFO - 1) * VM_FRAME_SIZE);
+                nrf_nrx--;
+            }
+            break;
+        case NRF_FLUSH_TX:
+            nrf_ntx = 0;
+            break;
+        case NRF_FLUSH_RX:
+            nrf_nrx = 0;
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * One byte each way on SPI. MISO floats high while CSN is high.
+ */
+uint8_t nrf_exchange(uint8_t mosi){
+    uint8_t miso = 0x00;
+    if(nrf_csn_level){
+        return 0xFF;
+    }
+    if(nrf_pos == 0){
+        nrf_cmd = mosi;
+        nrf_nload = 0;
+        miso = nrf_status();            // Always clocked out with the command
+    }
+    else if(nrf_cmd < NRF_W_REGISTER){
+        miso = ((nrf_cmd & 0x1F) == NRF_STATUS) ? nrf_status() : nrf_reg[nrf_cmd & 0x1F];
+    }
+    else if(nrf_cmd < 0x40){
+        if(nrf_pos == 1){
+            nrf_write(nrf_cmd & 0x1F, mosi);
+        }
+    }
+    else if(nrf_cmd == NRF_R_RX_PAYLOAD){
+        miso = (nrf_nrx > 0 && nrf_pos <= VM_FRAME_SIZE) ? nrf_rx[0][nrf_pos - 1] : 0x00;
+    }
+    else if(nrf_cmd == NRF_W_TX_PAYLOAD){
+        if(nrf_nload < VM_FRAME_SIZE){
+            nrf_load[nrf_nload++] = mosi;
+        }
+    }
+    if(nrf_pos < 0xFF){
+        nrf_pos++;
+    }
+    return miso;
+}
@@ -0,0 +1,132 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * A virtual node for the network simulator (netsim.c): the node firmware built against a virtual
+ * G2553 (g2553.c) and a virtual nRF24L01+ on USCI-B0 (nrf24.c) into simnode.so. The simulator loads
+ * one copy of the library per node so every node has its own globals, registers, and stack, and runs
+ * each node's main() as a coroutine on whichever host thread is free.
+ *
+ * Time only moves when the firmware touches a register, calls a delay, or sleeps. A register access
+ * costs VM_ACCESS_CYCLES, and the code run since the last one is charged then, block by block at an
+ * estimate from the host's instructions (sim/blocks.awk), so CPU time (and so active current) is
+ * only as good as that estimate. Sleeps jump straight to the next timer, USCI, ADC10, echo, or radio
+ * event.
+ *
+ * A node runs until the simulator's until time, or until its radio would have to know what was on
+ * the air after heard: the firmware starting an SPI command to an nRF24 that has been listening since
+ * heard. It then yields, the simulator works out what every radio heard up to a later time, and
+ * resumes it. A node never has to wait for another unless its receiver is on.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include "../../power.h"
+
+#ifndef VM_H_
+#define VM_H_
+
+typedef uint64_t VM_Time;
+
+#define VM_HZ               512000000ULL    // Common multiple of the 16 MHz DCO and the 32768 Hz ACLK
+#define VM_US(us)           ((VM_Time)(us) * (VM_HZ / 1000000))
+#define VM_SECONDS(t)       ((double)(t) / VM_HZ)
+#define VM_NEVER            UINT64_MAX
+#define VM_ACCESS_CYCLES    4               // CPU cycles charged per register access
+#define VM_FRAME_SIZE       32              // nRF24 payload
+#define VM_OUTBOX           32
+#define VM_INBOX            32
+#define VM_RX_SPANS         8
+#define VM_STACK_SIZE       (64*1024)
+#define VM_RAM              0x0200          // G2553 RAM, where the ADC10's DTC can write
+#define VM_RAM_SIZE         512
+
+// Why a node gave control back
+typedef enum VM_StatusEnum{
+    VM_RUNNING,
+    VM_PAUSED,                          // Reached until
+    VM_BLOCKED,                         // Needs the air resolved up to now, or its outbox emptied
+    VM_HALTED                           // Stopped for good, see halt
+} VM_Status;
+
+// A frame on the air
+typedef struct VM_FrameStruct{
+    VM_Time start;                      // First bit of the preamble
+    VM_Time end;
+    VM_Time sampled;                    // Uplinks: first sensor reading since the last frame, VM_NEVER if none
+    uint8_t data[VM_FRAME_SIZE];
+} VM_Frame;
+
+// A span of time the receiver was listening, end is VM_NEVER while it still is
+typedef struct VM_SpanStruct{
+    VM_Time start;
+    VM_Time end;
+} VM_Span;
+
+// Sensor input, ex: temperature in C or snow depth in mm at a time in seconds from the start
+typedef double (*VM_Env)(void *ctx, uint8_t node, uint8_t sensor, double seconds);
+
+typedef struct VM_NodeStruct{
+    // Set by the simulator
+    uint8_t id;                         // NODE_ID
+    uint64_t seed;
+    VM_Time boot;                       // Powers up here
+    int (*entry)(void);                 // Runs instead of the firmware's main() if set, ex: drvbench.c
+    VM_Env env;
+    void *env_ctx;
+    VM_Time until;
+    VM_Time heard;                      // Every frame that ends by here has been put in the inbox
+    // Set by the node
+    VM_Time now;
+    VM_Status status;
+    const char *halt;
+    VM_Frame outbox[VM_OUTBOX];         // Frames sent, emptied by the simulator
+    uint32_t nout;
+    VM_Frame inbox[VM_INBOX];           // Frames on the air while the receiver was on, filled by the simulator
+    uint32_t in_head, in_tail;
+    VM_Span rx[VM_RX_SPANS];
+    uint32_t nrx;
+    VM_Time spent[PWR_NUM_STATES];      // Time in each state, from the virtual hardware, not power.c
+    const uint16_t *ua;                 // Current drawn in each state (power.c)
+    uint64_t accesses;
+    uint64_t interrupts;
+    uint64_t rx_frames;                 // Put in the nRF24 RX FIFO
+    uint64_t rx_dropped;                // Heard with the RX FIFO full
+} VM_Node;
+
+// Exported by simnode.so
+typedef int (*VM_StartFn)(void);
+typedef void (*VM_ResumeFn)(void);
+int vm_start(void);
+void vm_resume(void);
+
+/*
+ * Inside the virtual node
+ */
+extern VM_Node vm_node;
+extern VM_Time vm_now;
+extern char *vm_stack;                  // VM_STACK_SIZE bytes the node runs on
+extern uint8_t vm_ram[VM_RAM_SIZE];     // Filled by the DTC, the rest of RAM is the host's
+
+void vm_account(void);
+void vm_settle(void);                   // Moves time on over the code run since the last register access
+void vm_changed(void);
+void vm_block(void);
+uint64_t vm_random(void);
+void vm_reseed(uint64_t seed);
+VM_Time vm_smclk_cycles(uint32_t cycles);
+
+// Virtual nRF24L01+, CSN on P1.5 and CE on P2.3
+void nrf_reset(void);
+void nrf_csn(uint8_t level);
+void nrf_ce(uint8_t level);
+uint8_t nrf_exchange(uint8_t mosi);
+VM_Time nrf_next_event(void);
+void nrf_event(void);
+PWR_State nrf_state(void);
+void nrf_sampled(void);
+
+#endif /* VM_H_ */
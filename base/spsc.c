@@ -0,0 +1,112 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Lock-free single producer, single consumer ring, see spsc.h
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "spsc.h"
+
+/*
+ * Sets up an empty queue. capacity has to be a power of 2.
+ */
+int spsc_init(SPSC_Queue *q, size_t elem_size, size_t capacity){
+    if(capacity == 0 || (capacity & (capacity - 1)) != 0){
+        return -1;
+    }
+    memset(q, 0, sizeof(*q));
+    q->slots = malloc(elem_size * capacity);
+    if(q->slots == NULL){
+        return -1;
+    }
+    q->mask = capacity - 1;
+    q->elem_size = elem_size;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->closed, 0);
+    atomic_init(&q->full, 0);
+    atomic_init(&q->high_water, 0);
+    return 0;
+}
+
+void spsc_free(SPSC_Queue *q){
+    free(q->slots);
+    q->slots = NULL;
+}
+
+/*
+ * Producer only. Returns -1 if the queue is full, counted in full only if the last push got in.
+ * head is only reloaded when the cached copy says the queue is full, and the high water mark is
+ * taken from the depth seen then, so it is sampled once per trip of the producer around the ring
+ * rather than on every push.
+ */
+int spsc_push(SPSC_Queue *q, const void *item){
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed), depth;
+    if(tail - q->head_cache > q->mask){
+        q->head_cache = atomic_load_explicit(&q->head, memory_order_acquire);
+        depth = tail - q->head_cache;
+        if(depth > q->mask){
+            if(!q->blocked){
+                atomic_fetch_add_explicit(&q->full, 1, memory_order_relaxed);
+                q->blocked = 1;
+            }
+            atomic_store_explicit(&q->high_water, q->mask + 1, memory_order_relaxed);
+            return -1;
+        }
+        if(depth + 1 > atomic_load_explicit(&q->high_water, memory_order_relaxed)){
+            atomic_store_explicit(&q->high_water, depth + 1, memory_order_relaxed);
+        }
+    }
+    q->blocked = 0;
+    memcpy(&q->slots[(tail & q->mask) * q->elem_size], item, q->elem_size);
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return 0;
+}
+
+/*
+ * Consumer only. Returns -1 if the queue is empty.
+ */
+int spsc_pop(SPSC_Queue *q, void *item){
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    if(head == q->tail_cache){
+        q->tail_cache = atomic_load_explicit(&q->tail, memory_order_acquire);
+        if(head == q->tail_cache){
+            return -1;
+        }
+    }
+    memcpy(item, &q->slots[(head & q->mask) * q->elem_size], q->elem_size);
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return 0;
+}
+
+/*
+ * Items queued right now, from either side
+ */
+size_t spsc_count(SPSC_Queue *q){
+    return atomic_load_explicit(&q->tail, memory_order_acquire) - atomic_load_explicit(&q->head, memory_order_acquire);
+}
+
+/*
+ * Producer only, after its last push
+ */
+void spsc_close(SPSC_Queue *q){
+    atomic_store_explicit(&q->closed, 1, memory_order_release);
+}
+
+/*
+ * Consumer only. Returns 1 once the producer has closed the queue and every item has been popped.
+ */
+int spsc_done(SPSC_Queue *q){
+    if(!atomic_load_explicit(&q->closed, memory_order_acquire)){
+        return 0;
+    }
+    return spsc_count(q) == 0;
+}
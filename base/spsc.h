@@ -0,0 +1,50 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Lock-free single producer, single consumer ring of fixed size items. The head is only written by
+ * the consumer and the tail only by the producer, each on its own cache line, and each side keeps
+ * a cached copy of the other's index so the shared lines are only touched when the cache runs out.
+ * Pushing to a full queue fails and is counted once per wait, however many times the producer tries
+ * again before there is room, so backpressure shows up in the statistics.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#ifndef SPSC_H_
+#define SPSC_H_
+
+#define SPSC_LINE           64          // Cache line size
+
+typedef struct SPSC_QueueStruct{
+    // Producer's line
+    _Alignas(SPSC_LINE) atomic_size_t tail;     // Next slot to push
+    size_t head_cache;                  // Producer's last look at head
+    atomic_uint_fast64_t full;          // Times the producer found the queue full and had to wait
+    int blocked;                        // The last push failed
+    atomic_size_t high_water;           // Most items seen queued when head_cache was refreshed
+    // Consumer's line
+    _Alignas(SPSC_LINE) atomic_size_t head;     // Next slot to pop
+    size_t tail_cache;                  // Consumer's last look at tail
+    // Read only after init
+    _Alignas(SPSC_LINE) size_t mask;
+    size_t elem_size;
+    uint8_t *slots;
+    atomic_int closed;                  // Producer is done, the consumer drains what is left
+} SPSC_Queue;
+
+int spsc_init(SPSC_Queue *q, size_t elem_size, size_t capacity);
+void spsc_free(SPSC_Queue *q);
+int spsc_push(SPSC_Queue *q, const void *item);
+int spsc_pop(SPSC_Queue *q, void *item);
+size_t spsc_count(SPSC_Queue *q);
+void spsc_close(SPSC_Queue *q);
+int spsc_done(SPSC_Queue *q);
+
+#endif /* SPSC_H_ */
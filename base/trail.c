@@ -0,0 +1,343 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Trail conditions at the base station, see trail.h
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../packet.h"
+#include "trail.h"
+
+static const char *tr_names[TR_CONDITIONS] = {"unknown", "fast", "icy", "slushy", "needs grooming"};
+
+/*
+ * Queue
+ */
+static int tr_push(TR_Queue *q, double t, double v){
+    TR_Sample *buf;
+    uint32_t i;
+    if(q->n == q->cap){                 // Grow, unwrapping into the new buffer
+        buf = malloc((q->cap ? q->cap * 2 : 64) * sizeof(*buf));
+        if(buf == NULL){
+            return -1;
+        }
+        for(i=0; i<q->n; i++){
+            buf[i] = q->buf[(q->head + i) % q->cap];
+        }
+        free(q->buf);
+        q->buf = buf;
+        q->head = 0;
+        q->cap = q->cap ? q->cap * 2 : 64;
+    }
+    q->buf[(q->head + q->n) % q->cap] = (TR_Sample){t, v};
+    q->n++;
+    return 0;
+}
+
+static TR_Sample *tr_front(TR_Queue *q){
+    return &q->buf[q->head];
+}
+
+static TR_Sample *tr_back(TR_Queue *q){
+    return &q->buf[(q->head + q->n - 1) % q->cap];
+}
+
+static void tr_pop_front(TR_Queue *q){
+    q->head = (q->head + 1) % q->cap;
+    q->n--;
+}
+
+static void tr_pop_back(TR_Queue *q){
+    q->n--;
+}
+
+/*
+ * Drops samples older than start from the front of a queue
+ */
+static void tr_expire(TR_Queue *q, double start){
+    while(q->n > 0 && tr_front(q)->t < start){
+        tr_pop_front(q);
+    }
+}
+
+/*
+ * Pushes onto a monotonic deque, dropping samples from the back that can never be the min (or the
+ * max if sign is -1) again while v is in the window
+ */
+static int tr_push_mono(TR_Queue *q, double t, double v, int sign){
+    while(q->n > 0 && sign * tr_back(q)->v >= sign * v){
+        tr_pop_back(q);
+    }
+    return tr_push(q, t, v);
+}
+
+static void tr_queue_free(TR_Queue *q){
+    free(q->buf);
+    memset(q, 0, sizeof(*q));
+}
+
+/*
+ * Model
+ */
+void trail_init(TR_Model *m, double window_hours){
+    uint16_t i;
+    memset(m, 0, sizeof(*m));
+    m->window = window_hours * 3600.0;
+    for(i=0; i<TR_MAX_NODES; i++){
+        m->nodes[i].segment = TR_NO_SEGMENT;
+    }
+}
+
+void trail_free(TR_Model *m){
+    uint16_t i;
+    TR_Node *n;
+    for(i=0; i<TR_MAX_NODES; i++){
+        n = &m->nodes[i];
+        tr_queue_free(&n->tmin);
+        tr_queue_free(&n->tmax);
+        tr_queue_free(&n->refreeze);
+        tr_queue_free(&n->above);
+        tr_queue_free(&n->depth);
+        tr_queue_free(&n->dmin);
+    }
+}
+
+/*
+ * Returns the index of a segment, adding it if it's new, or -1 if there are too many
+ */
+int trail_segment(TR_Model *m, const char *name){
+    uint8_t i;
+    for(i=0; i<m->nsegments; i++){
+        if(strcmp(m->segments[i].name, name) == 0){
+            return i;
+        }
+    }
+    if(m->nsegments == TR_MAX_SEGMENTS){
+        return -1;
+    }
+    snprintf(m->segments[i].name, TR_NAME_SIZE, "%s", name);
+    m->segments[i].condition = TR_UNKNOWN;
+    m->segments[i].dirty = 1;
+    return m->nsegments++;
+}
+
+int trail_assign(TR_Model *m, uint8_t node, uint8_t segment){
+    if(segment >= m->nsegments){
+        return -1;
+    }
+    m->nodes[node].segment = segment;
+    m->segments[segment].dirty = 1;
+    return 0;
+}
+
+/*
+ * Reads which segment each node is on from lines of "node segment name". Returns -1 if the file
+ * can't be read or a line is bad.
+ */
+int trail_load(TR_Model *m, const char *path){
+    FILE *f = fopen(path, "r");
+    char line[128], name[TR_NAME_SIZE];
+    int node, seg, err = 0;
+    if(f == NULL){
+        return -1;
+    }
+    while(fgets(line, sizeof(line), f) != NULL){
+        if(line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0'){
+            continue;
+        }
+        if(sscanf(line, "%d %31[^\r\n]", &node, name) != 2 || node < 0 || node >= TR_MAX_NODES
+           || (seg = trail_segment(m, name)) < 0){
+            err = -1;
+            break;
+        }
+        trail_assign(m, node, seg);
+    }
+    fclose(f);
+    return err;
+}
+
+/*
+ * Moves the end of a node's window up to now and drops whatever fell out of it
+ */
+static void tr_slide(TR_Model *m, TR_Node *n, double now){
+    double start;
+    if(now <= n->now){
+        return;
+    }
+    n->now = now;
+    start = now - m->window;
+    tr_expire(&n->tmin, start);
+    tr_expire(&n->tmax, start);
+    tr_expire(&n->refreeze, start);
+    tr_expire(&n->depth, start);
+    tr_expire(&n->dmin, start);
+    while(n->above.n > 0 && tr_front(&n->above)->t + tr_front(&n->above)->v <= start){
+        n->above_sum -= tr_front(&n->above)->v;
+        tr_pop_front(&n->above);
+    }
+}
+
+/*
+ * Works out a node's inputs and marks its segment if they changed. Returns 1 if they did.
+ */
+static int tr_refresh(TR_Model *m, TR_Node *n){
+    TR_Inputs in;
+    double above = n->above_sum, start = n->now - m->window;
+
+    memset(&in, 0, sizeof(in));         // Compared with memcmp, padding included
+    if(n->tmin.n > 0){                  // Nothing if the last reading aged out
+        in.have_temp = 1;
+        in.temp = n->temp;
+        in.temp_min = (int16_t)tr_front(&n->tmin)->v;
+        in.temp_max = (int16_t)tr_front(&n->tmax)->v;
+        in.freeze_thaw = n->refreeze.n;
+        if(n->above.n > 0 && tr_front(&n->above)->t < start){
+            above -= start - tr_front(&n->above)->t;    // Only part of the oldest span is in the window
+        }
+        if(n->temp > 0){
+            above += n->now - ((n->temp_time > start) ? n->temp_time : start);    // Span still going
+        }
+        in.above_tenths = (uint16_t)(above / 360.0);
+    }
+    if(n->depth.n > 0){
+        in.have_depth = 1;                      // Lowest and oldest are always in the window with the latest
+        in.new_snow = (int16_t)(tr_back(&n->depth)->v - tr_front(&n->dmin)->v);
+        in.depth_change = (int16_t)(tr_back(&n->depth)->v - tr_front(&n->depth)->v);
+    }
+    if(memcmp(&in, &n->inputs, sizeof(in)) == 0){
+        return 0;
+    }
+    n->inputs = in;
+    if(n->segment != TR_NO_SEGMENT){
+        m->segments[n->segment].dirty = 1;
+    }
+    return 1;
+}
+
+/*
+ * Takes a reading from a node. Only temperature and snow depth are used. Readings older than the
+ * newest one from the node are ignored. Returns 1 if the node's inputs changed.
+ */
+int trail_update(TR_Model *m, uint8_t node, uint8_t sensor, double time, int16_t value){
+    TR_Node *n = &m->nodes[node];
+
+    if(time < n->last || (sensor != PKT_SEN_TEMP && sensor != PKT_SEN_DEPTH)){
+        return 0;
+    }
+    m->readings++;
+    n->last = time;
+    tr_slide(m, n, time);
+    if(sensor == PKT_SEN_TEMP){
+        tr_push_mono(&n->tmin, time, value, 1);
+        tr_push_mono(&n->tmax, time, value, -1);
+        if(n->have_temp && n->temp > 0 && time > n->temp_time){
+            tr_push(&n->above, n->temp_time, time - n->temp_time);  // Above 0 C since the last reading
+            n->above_sum += time - n->temp_time;
+        }
+        if(value >= TR_THAW_C){
+            n->thawed = 1;
+        }
+        else if(value <= TR_FREEZE_C){
+            if(n->thawed){
+                tr_push(&n->refreeze, time, 0);
+            }
+            n->thawed = 0;
+        }
+        n->temp = value;
+        n->temp_time = time;
+        n->have_temp = 1;
+    }
+    else{
+        tr_push(&n->depth, time, value);
+        tr_push_mono(&n->dmin, time, value, 1);
+    }
+    return tr_refresh(m, n);
+}
+
+/*
+ * Slides every node's window up to now so old readings age out of quiet nodes too. Returns the
+ * number of nodes whose inputs changed.
+ */
+int trail_advance(TR_Model *m, double now){
+    uint16_t i;
+    int changed = 0;
+    for(i=0; i<TR_MAX_NODES; i++){
+        if(m->nodes[i].have_temp || m->nodes[i].depth.n > 0){
+            tr_slide(m, &m->nodes[i], now);
+            changed += tr_refresh(m, &m->nodes[i]);
+        }
+    }
+    return changed;
+}
+
+/*
+ * Returns 1 if any segment's condition needs working out again
+ */
+int trail_dirty(const TR_Model *m){
+    uint8_t i;
+    for(i=0; i<m->nsegments; i++){
+        if(m->segments[i].dirty){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static TR_Condition tr_classify(const TR_Inputs *in){
+    if(!in->have_temp){
+        return TR_UNKNOWN;
+    }
+    if(in->have_depth && in->new_snow >= TR_GROOM_MM){
+        return TR_GROOM;
+    }
+    if(in->temp > 0 && in->above_tenths >= TR_SLUSH_TENTHS){
+        return TR_SLUSHY;
+    }
+    if(in->freeze_thaw > 0 && in->temp <= 0){
+        return TR_ICY;
+    }
+    return TR_FAST;
+}
+
+/*
+ * A segment's condition, only worked out again if a node's inputs changed since last time. Fills
+ * inputs with those of the node that decided it if inputs isn't NULL.
+ */
+TR_Condition trail_condition(TR_Model *m, uint8_t segment, TR_Inputs *inputs){
+    TR_Segment *s = &m->segments[segment];
+    TR_Condition c;
+    uint16_t i;
+
+    if(s->dirty){
+        m->recomputes++;
+        s->condition = TR_UNKNOWN;
+        memset(&s->inputs, 0, sizeof(s->inputs));
+        for(i=0; i<TR_MAX_NODES; i++){
+            if(m->nodes[i].segment != segment){
+                continue;
+            }
+            c = tr_classify(&m->nodes[i].inputs);
+            if(c > s->condition || (c == s->condition && s->condition == TR_UNKNOWN)){
+                s->condition = c;
+                s->inputs = m->nodes[i].inputs;
+            }
+        }
+        s->dirty = 0;
+    }
+    if(inputs != NULL){
+        *inputs = s->inputs;
+    }
+    return s->condition;
+}
+
+const char *trail_condition_name(TR_Condition c){
+    return (c < TR_CONDITIONS) ? tr_names[c] : "?";
+}
@@ -0,0 +1,118 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Trail conditions at the base station, kept up to date reading by reading. Every node keeps sliding
+ * window aggregates of its temperature and snow depth readings, each updated in O(1) amortized time:
+ *
+ *  temperature min/max     monotonic deques
+ *  freeze-thaw cycles      queue of the times the temperature refroze after a thaw
+ *  hours above 0 C         queue of the spans spent above 0 C and their running sum
+ *  new snow                latest depth less the window's lowest (monotonic deque)
+ *  depth change            latest depth less the oldest in the window (queue)
+ *
+ * A node belongs to a trail segment and a segment's condition is the worst of its nodes'. The
+ * aggregates that decide the condition are compared after every reading, and a segment's condition
+ * is only worked out again when one of them changed.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+
+#ifndef TRAIL_H_
+#define TRAIL_H_
+
+#define TR_MAX_NODES        256
+#define TR_MAX_SEGMENTS     64
+#define TR_NO_SEGMENT       0xFF
+#define TR_NAME_SIZE        32
+#define TR_WINDOW_H         24.0        // Default window
+#define TR_THAW_C           1           // Thawed at or above, frozen at or below TR_FREEZE_C
+#define TR_FREEZE_C         (-1)
+#define TR_GROOM_MM         100         // New snow that needs grooming
+#define TR_SLUSH_TENTHS     20          // Tenths of an hour above 0 C before a thawed trail is slushy
+
+// Conditions, from least to most in need of attention
+typedef enum TR_ConditionEnum{
+    TR_UNKNOWN,                         // No temperature yet
+    TR_FAST,                            // Cold and settled
+    TR_ICY,                             // Refrozen after a thaw
+    TR_SLUSHY,                          // Thawed for a while
+    TR_GROOM,                           // New snow
+    TR_CONDITIONS
+} TR_Condition;
+
+typedef struct TR_SampleStruct{
+    double t;                           // Seconds
+    double v;
+} TR_Sample;
+
+// Ring of samples used as a FIFO queue or a monotonic deque
+typedef struct TR_QueueStruct{
+    TR_Sample *buf;
+    uint32_t cap, head, n;
+} TR_Queue;
+
+// What a condition is decided from, only compared whole
+typedef struct TR_InputsStruct{
+    int16_t temp;                       // Latest, C
+    int16_t temp_min;
+    int16_t temp_max;
+    int16_t new_snow;                   // mm
+    int16_t depth_change;               // mm
+    uint16_t freeze_thaw;
+    uint16_t above_tenths;              // Tenths of an hour above 0 C
+    uint8_t have_temp;
+    uint8_t have_depth;
+} TR_Inputs;
+
+typedef struct TR_NodeStruct{
+    uint8_t segment;
+    double now;                         // The window ends here
+    double last;                        // Newest reading
+    // Temperature
+    TR_Queue tmin, tmax;
+    TR_Queue refreeze;                  // Times it refroze, v is unused
+    TR_Queue above;                     // Start time and length of each span above 0 C
+    double above_sum;                   // Seconds in the above queue
+    double temp_time;
+    int16_t temp;
+    uint8_t have_temp;
+    uint8_t thawed;
+    // Depth
+    TR_Queue depth;                     // Every reading in the window
+    TR_Queue dmin;
+    TR_Inputs inputs;
+} TR_Node;
+
+typedef struct TR_SegmentStruct{
+    char name[TR_NAME_SIZE];
+    uint8_t dirty;                      // Inputs of a node changed since the condition was worked out
+    TR_Condition condition;
+    TR_Inputs inputs;                   // Of the node that decided the condition
+} TR_Segment;
+
+typedef struct TR_ModelStruct{
+    double window;                      // Seconds
+    uint8_t nsegments;
+    TR_Segment segments[TR_MAX_SEGMENTS];
+    TR_Node nodes[TR_MAX_NODES];
+    uint64_t readings;
+    uint64_t recomputes;                // Segment conditions worked out
+} TR_Model;
+
+void trail_init(TR_Model *m, double window_hours);
+void trail_free(TR_Model *m);
+int trail_segment(TR_Model *m, const char *name);
+int trail_assign(TR_Model *m, uint8_t node, uint8_t segment);
+int trail_load(TR_Model *m, const char *path);
+int trail_update(TR_Model *m, uint8_t node, uint8_t sensor, double time, int16_t value);
+int trail_advance(TR_Model *m, double now);
+int trail_dirty(const TR_Model *m);
+TR_Condition trail_condition(TR_Model *m, uint8_t segment, TR_Inputs *inputs);
+const char *trail_condition_name(TR_Condition c);
+
+#endif /* TRAIL_H_ */
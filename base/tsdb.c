@@ -0,0 +1,630 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Append-only time series store, see tsdb.h
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "tsdb.h"
+
+#define TS_NO_WINDOW        0xFF        // TS_Mark.lead before the first XOR window
+#define TS_MAX_POINT_BITS   113         // Longest a point can encode to, 4+32 time and 2+5+6+64 value
+#define TS_DATA_BITS        ((int)TS_DATA_SIZE * 8)
+
+static const int64_t ts_width[TS_LEVELS] = {60000, 3600000, 86400000};     // Rollup bucket widths in ms
+
+#define TS_AT(db, off)      ((TS_Block *)&(db)->map[off])
+#define TS_DATA(b)          ((uint8_t *)(b) + sizeof(TS_Block))
+#define TS_BUCKET(b)        ((TS_Bucket *)TS_DATA(b))
+#define TS_HEADER(db)       ((TS_Header *)(db)->map)
+
+static int64_t ts_ms(double seconds){
+    return llround(seconds * 1000.0);
+}
+
+static uint64_t ts_bits(double v){
+    uint64_t x;
+    memcpy(&x, &v, sizeof(x));
+    return x;
+}
+
+static double ts_double(uint64_t x){
+    double v;
+    memcpy(&v, &x, sizeof(v));
+    return v;
+}
+
+/*
+ * Bit stream, most significant bit first. The data area starts out zeroed so bits are or'd in.
+ */
+static void ts_put(uint8_t *data, uint16_t *bit, uint64_t value, uint8_t n){
+    uint8_t room, take;
+    while(n > 0){
+        room = 8 - (*bit & 7);
+        take = (n < room) ? n : room;
+        data[*bit >> 3] |= ((value >> (n - take)) & ((1u << take) - 1)) << (room - take);
+        *bit += take;
+        n -= take;
+    }
+}
+
+static uint64_t ts_get(const uint8_t *data, uint16_t *bit, uint8_t n){
+    uint64_t value = 0;
+    uint8_t room, take;
+    while(n > 0){
+        room = 8 - (*bit & 7);
+        take = (n < room) ? n : room;
+        value = (value << take) | ((data[*bit >> 3] >> (room - take)) & ((1u << take) - 1));
+        *bit += take;
+        n -= take;
+    }
+    return value;
+}
+
+static int64_t ts_signed(uint64_t value, uint8_t n){
+    return (int64_t)(value << (64 - n)) >> (64 - n);
+}
+
+/*
+ * Appends a point after the mark, which is left as the state after it
+ */
+static void ts_encode(uint8_t *data, TS_Mark *m, int64_t t, double v){
+    int32_t delta = (int32_t)(t - m->t);
+    int32_t dod = delta - m->delta;
+    uint64_t x = ts_bits(v) ^ ts_bits(m->v);
+    uint8_t lead, trail, len;
+
+    if(dod == 0){
+        ts_put(data, &m->bit, 0x0, 1);
+    }
+    else if(dod >= -64 && dod <= 63){
+        ts_put(data, &m->bit, 0x2, 2);
+        ts_put(data, &m->bit, (uint32_t)dod, 7);
+    }
+    else if(dod >= -256 && dod <= 255){
+        ts_put(data, &m->bit, 0x6, 3);
+        ts_put(data, &m->bit, (uint32_t)dod, 9);
+    }
+    else if(dod >= -2048 && dod <= 2047){
+        ts_put(data, &m->bit, 0xE, 4);
+        ts_put(data, &m->bit, (uint32_t)dod, 12);
+    }
+    else{
+        ts_put(data, &m->bit, 0xF, 4);
+        ts_put(data, &m->bit, (uint32_t)dod, 32);
+    }
+
+    if(x == 0){
+        ts_put(data, &m->bit, 0x0, 1);
+    }
+    else{
+        lead = __builtin_clzll(x);
+        trail = __builtin_ctzll(x);
+        if(lead > 31){
+            lead = 31;                  // Only 5 bits to say it in
+        }
+        if(m->lead != TS_NO_WINDOW && lead >= m->lead && trail >= m->trail){
+            ts_put(data, &m->bit, 0x2, 2);      // Fits the last window
+            ts_put(data, &m->bit, x >> m->trail, 64 - m->lead - m->trail);
+        }
+        else{
+            len = 64 - lead - trail;
+            ts_put(data, &m->bit, 0x3, 2);
+            ts_put(data, &m->bit, lead, 5);
+            ts_put(data, &m->bit, len - 1, 6);
+            ts_put(data, &m->bit, x >> trail, len);
+            m->lead = lead;
+            m->trail = trail;
+        }
+    }
+    m->t = t;
+    m->v = v;
+    m->delta = delta;
+}
+
+/*
+ * Reads the point after the mark, which is left as the state after it
+ */
+static void ts_decode(const uint8_t *data, TS_Mark *m){
+    int64_t dod;
+    uint64_t x;
+    uint8_t len;
+
+    if(ts_get(data, &m->bit, 1) == 0){
+        dod = 0;
+    }
+    else if(ts_get(data, &m->bit, 1) == 0){
+        dod = ts_signed(ts_get(data, &m->bit, 7), 7);
+    }
+    else if(ts_get(data, &m->bit, 1) == 0){
+        dod = ts_signed(ts_get(data, &m->bit, 9), 9);
+    }
+    else if(ts_get(data, &m->bit, 1) == 0){
+        dod = ts_signed(ts_get(data, &m->bit, 12), 12);
+    }
+    else{
+        dod = ts_signed(ts_get(data, &m->bit, 32), 32);
+    }
+    m->delta += (int32_t)dod;
+    m->t += m->delta;
+
+    if(ts_get(data, &m->bit, 1) == 0){
+        return;                         // Same value
+    }
+    if(ts_get(data, &m->bit, 1) == 0){
+        x = ts_get(data, &m->bit, 64 - m->lead - m->trail) << m->trail;
+    }
+    else{
+        m->lead = ts_get(data, &m->bit, 5);
+        len = ts_get(data, &m->bit, 6) + 1;
+        m->trail = 64 - m->lead - len;
+        x = ts_get(data, &m->bit, len) << m->trail;
+    }
+    m->v = ts_double(ts_bits(m->v) ^ x);
+}
+
+static int ts_list_add(TS_List *l, uint64_t off){
+    uint64_t *offs;
+    if(l->n == l->cap){
+        l->cap = l->cap ? l->cap * 2 : 16;
+        offs = realloc(l->offs, l->cap * sizeof(*offs));
+        if(offs == NULL){
+            return -1;
+        }
+        l->offs = offs;
+    }
+    l->offs[l->n++] = off;
+    return 0;
+}
+
+static TS_Series *ts_series(TS_DB *db, uint8_t node, uint8_t sensor, int create){
+    TS_Series **s = &db->series[TS_SERIES(node, sensor)];
+    if(*s == NULL && create){
+        *s = calloc(1, sizeof(TS_Series));
+    }
+    return *s;
+}
+
+/*
+ * First block in a list whose span reaches t, or l->n if none
+ */
+static uint32_t ts_seek(TS_DB *db, const TS_List *l, int64_t t){
+    uint32_t lo = 0, hi = l->n, mid;
+    while(lo < hi){
+        mid = (lo + hi) / 2;
+        if(TS_AT(db, l->offs[mid])->t_last < t){
+            lo = mid + 1;
+        }
+        else{
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/*
+ * Takes a new block off the end of the file, growing it if needed. Returns its offset or 0.
+ */
+static uint64_t ts_alloc(TS_DB *db){
+    uint64_t off = TS_HEADER(db)->end;
+    uint8_t *map;
+    if(off + TS_BLOCK > db->size){
+        if(ftruncate(db->fd, db->size + TS_GROW) != 0){
+            return 0;
+        }
+        map = mmap(NULL, db->size + TS_GROW, PROT_READ | PROT_WRITE, MAP_SHARED, db->fd, 0);
+        if(map == MAP_FAILED){
+            return 0;
+        }
+        munmap(db->map, db->size);      // Queries hold the lock, so nothing points into the old map
+        db->map = map;
+        db->size += TS_GROW;
+    }
+    TS_HEADER(db)->end = off + TS_BLOCK;
+    return off;
+}
+
+/*
+ * Starts a block of a series. The caller fills in the rest and sets count last.
+ */
+static TS_Block *ts_start(TS_DB *db, TS_List *l, uint32_t type, uint8_t node, uint8_t sensor, uint8_t level){
+    uint64_t off = ts_alloc(db);
+    TS_Block *b;
+    if(off == 0 || ts_list_add(l, off) != 0){
+        return NULL;
+    }
+    b = TS_AT(db, off);
+    b->node = node;
+    b->sensor = sensor;
+    b->level = level;
+    b->type = type;
+    return b;
+}
+
+static int ts_raw_add(TS_DB *db, TS_Series *s, uint8_t node, uint8_t sensor, int64_t t, double v){
+    TS_Block *b = s->raw.n ? TS_AT(db, s->raw.offs[s->raw.n - 1]) : NULL;
+    int64_t delta, dod;
+
+    if(b != NULL){
+        if(t < b->t_last){
+            return -1;
+        }
+        delta = t - b->tail.t;
+        dod = delta - b->tail.delta;
+        if(b->count == TS_INDEX_SLOTS * TS_INDEX_EVERY || b->tail.bit + TS_MAX_POINT_BITS > TS_DATA_BITS
+           || delta > INT32_MAX || dod < INT32_MIN || dod > INT32_MAX){
+            b = NULL;                   // Full, or too long a gap to encode, so start another
+        }
+    }
+    if(b == NULL){
+        b = ts_start(db, &s->raw, TS_RAW, node, sensor, 0);
+        if(b == NULL){
+            return -1;
+        }
+        b->t_first = b->t_last = t;
+        b->min = b->max = b->sum = v;
+        b->tail.t = t;
+        b->tail.v = v;
+        b->tail.delta = 0;
+        b->tail.bit = 0;
+        b->tail.lead = TS_NO_WINDOW;
+        b->tail.trail = 0;
+        b->index[0] = b->tail;
+        b->count = 1;
+        return 0;
+    }
+
+    ts_encode(TS_DATA(b), &b->tail, t, v);
+    if(b->count % TS_INDEX_EVERY == 0){
+        b->index[b->count / TS_INDEX_EVERY] = b->tail;
+    }
+    b->t_last = t;
+    b->min = (v < b->min) ? v : b->min;
+    b->max = (v > b->max) ? v : b->max;
+    b->sum += v;
+    b->count++;
+    return 0;
+}
+
+static int ts_rollup_add(TS_DB *db, TS_Series *s, uint8_t node, uint8_t sensor, TS_Level level, int64_t t, double v){
+    TS_List *l = &s->rollup[level];
+    TS_Block *b = l->n ? TS_AT(db, l->offs[l->n - 1]) : NULL;
+    int64_t start = t - (((t % ts_width[level]) + ts_width[level]) % ts_width[level]);
+    TS_Bucket *k;
+
+    if(b != NULL && b->t_last == start){
+        k = &TS_BUCKET(b)[b->count - 1];
+        k->min = (v < k->min) ? v : k->min;
+        k->max = (v > k->max) ? v : k->max;
+        k->sum += v;
+        k->count++;
+        return 0;
+    }
+    if(b == NULL || b->count == TS_BUCKETS){
+        b = ts_start(db, l, TS_ROLLUP, node, sensor, level);
+        if(b == NULL){
+            return -1;
+        }
+        b->t_first = start;
+    }
+    k = &TS_BUCKET(b)[b->count];
+    k->start = start;
+    k->min = k->max = k->sum = v;
+    k->count = 1;
+    b->t_last = start;
+    b->count++;
+    return 0;
+}
+
+/*
+ * Opens or creates a store. A read only store is a snapshot of the file as it was when opened.
+ */
+int ts_open(TS_DB *db, const char *path, int writable){
+    struct stat st;
+    uint64_t off;
+    TS_Block *b;
+    TS_Series *s;
+
+    memset(db, 0, sizeof(*db));
+    db->writable = writable;
+    db->fd = open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if(db->fd < 0 || fstat(db->fd, &st) != 0){
+        return -1;
+    }
+    db->size = st.st_size;
+    if(db->size == 0 && writable){
+        if(ftruncate(db->fd, TS_GROW) != 0){
+            close(db->fd);
+            return -1;
+        }
+        db->size = TS_GROW;
+    }
+    if(db->size < TS_BLOCK){
+        close(db->fd);
+        return -1;
+    }
+    db->map = mmap(NULL, db->size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, db->fd, 0);
+    if(db->map == MAP_FAILED){
+        close(db->fd);
+        return -1;
+    }
+    if(TS_HEADER(db)->end == 0 && writable){
+        memcpy(TS_HEADER(db)->magic, TS_MAGIC, sizeof(TS_HEADER(db)->magic));
+        TS_HEADER(db)->block = TS_BLOCK;
+        TS_HEADER(db)->end = TS_BLOCK;
+    }
+    if(memcmp(TS_HEADER(db)->magic, TS_MAGIC, sizeof(TS_HEADER(db)->magic)) != 0
+       || TS_HEADER(db)->block != TS_BLOCK || TS_HEADER(db)->end > db->size){
+        munmap(db->map, db->size);
+        close(db->fd);
+        return -1;
+    }
+
+    pthread_rwlock_init(&db->lock, NULL);
+    for(off=TS_BLOCK; off<TS_HEADER(db)->end; off+=TS_BLOCK){    // Blocks are in time order within a series
+        b = TS_AT(db, off);
+        if(b->count == 0){
+            continue;                   // Allocated but never written
+        }
+        s = ts_series(db, b->node, b->sensor, 1);
+        if(s == NULL){
+            ts_close(db);
+            return -1;
+        }
+        if(b->type == TS_RAW){
+            ts_list_add(&s->raw, off);
+        }
+        else if(b->type == TS_ROLLUP && b->level < TS_LEVELS){
+            ts_list_add(&s->rollup[b->level], off);
+        }
+    }
+    return 0;
+}
+
+void ts_close(TS_DB *db){
+    uint32_t i;
+    uint8_t level;
+    if(db->writable){
+        msync(db->map, TS_HEADER(db)->end, MS_SYNC);
+    }
+    munmap(db->map, db->size);
+    close(db->fd);
+    for(i=0; i<TS_MAX_SERIES; i++){
+        if(db->series[i] != NULL){
+            free(db->series[i]->raw.offs);
+            for(level=0; level<TS_LEVELS; level++){
+                free(db->series[i]->rollup[level].offs);
+            }
+            free(db->series[i]);
+        }
+    }
+    pthread_rwlock_destroy(&db->lock);
+}
+
+/*
+ * Starts writing dirty pages back without waiting for them
+ */
+int ts_sync(TS_DB *db){
+    int err;
+    pthread_rwlock_rdlock(&db->lock);
+    err = msync(db->map, TS_HEADER(db)->end, MS_ASYNC);
+    pthread_rwlock_unlock(&db->lock);
+    return err ? -1 : 0;
+}
+
+/*
+ * Appends a point to a series and its rollups. Returns -1 if the point is older than the last one
+ * in the series or the file can't grow.
+ */
+int ts_append(TS_DB *db, uint8_t node, uint8_t sensor, double time, double value){
+    int64_t t = ts_ms(time);
+    TS_Series *s;
+    int err = -1;
+    uint8_t level;
+
+    if(!db->writable){
+        return -1;
+    }
+    pthread_rwlock_wrlock(&db->lock);
+    s = ts_series(db, node, sensor, 1);
+    if(s != NULL && ts_raw_add(db, s, node, sensor, t, value) == 0){
+        err = 0;
+        for(level=0; level<TS_LEVELS; level++){
+            err |= ts_rollup_add(db, s, node, sensor, level, t, value);
+        }
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return err;
+}
+
+int ts_exists(TS_DB *db, uint8_t node, uint8_t sensor){
+    return db->series[TS_SERIES(node, sensor)] != NULL;
+}
+
+// Walks the points of a raw block from the last index mark at or before a time
+typedef struct TS_IterStruct{
+    const uint8_t *data;
+    TS_Mark m;
+    uint32_t left;                      // Points after the one in m
+    uint8_t first;                      // The point in m hasn't been handed out yet
+} TS_Iter;
+
+static void ts_iter_seek(TS_DB *db, TS_Iter *it, const TS_Block *b, int64_t t){
+    uint32_t count = b->count;          // Read once, the writer may be adding to the block
+    uint32_t lo = 0, hi = (count - 1) / TS_INDEX_EVERY, mid;
+    while(lo < hi){                     // Last mark at or before t
+        mid = (lo + hi + 1) / 2;
+        if(b->index[mid].t <= t){
+            lo = mid;
+        }
+        else{
+            hi = mid - 1;
+        }
+    }
+    it->data = TS_DATA(b);
+    it->m = b->index[lo];
+    it->left = count - 1 - lo * TS_INDEX_EVERY;
+    it->first = 1;
+    atomic_fetch_add_explicit(&db->touched, 1, memory_order_relaxed);
+}
+
+static int ts_iter_next(TS_DB *db, TS_Iter *it){
+    if(it->first){
+        it->first = 0;
+        atomic_fetch_add_explicit(&db->decoded, 1, memory_order_relaxed);
+        return 0;
+    }
+    if(it->left == 0){
+        return -1;
+    }
+    ts_decode(it->data, &it->m);
+    it->left--;
+    atomic_fetch_add_explicit(&db->decoded, 1, memory_order_relaxed);
+    return 0;
+}
+
+/*
+ * Points of a series from t0 to t1 (seconds), oldest first. Returns the number written to out.
+ */
+long ts_query_raw(TS_DB *db, uint8_t node, uint8_t sensor, double t0, double t1, TS_Point *out, long max){
+    int64_t a = ts_ms(t0), z = ts_ms(t1);
+    TS_Series *s;
+    TS_Block *b;
+    TS_Iter it;
+    uint32_t i;
+    long n = 0;
+
+    pthread_rwlock_rdlock(&db->lock);
+    s = ts_series(db, node, sensor, 0);
+    for(i=(s ? ts_seek(db, &s->raw, a) : 0); s && i<s->raw.n && n<max; i++){
+        b = TS_AT(db, s->raw.offs[i]);
+        if(b->t_first > z){
+            break;
+        }
+        ts_iter_seek(db, &it, b, a);
+        while(n < max && ts_iter_next(db, &it) == 0 && it.m.t <= z){
+            if(it.m.t >= a){
+                out[n].time = it.m.t / 1000.0;
+                out[n].value = it.m.v;
+                n++;
+            }
+        }
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return n;
+}
+
+/*
+ * Rollup buckets of a series starting from t0 to t1 (seconds), oldest first. Only rollup blocks are
+ * read. Returns the number written to out.
+ */
+long ts_query_rollup(TS_DB *db, uint8_t node, uint8_t sensor, TS_Level level, double t0, double t1, TS_Bucket *out, long max){
+    int64_t a = ts_ms(t0), z = ts_ms(t1);
+    TS_Series *s;
+    TS_Block *b;
+    uint32_t i, j, count;
+    long n = 0;
+
+    if(level >= TS_LEVELS){
+        return 0;
+    }
+    a -= ((a % ts_width[level]) + ts_width[level]) % ts_width[level];   // Include the bucket t0 is in
+    pthread_rwlock_rdlock(&db->lock);
+    s = ts_series(db, node, sensor, 0);
+    for(i=(s ? ts_seek(db, &s->rollup[level], a) : 0); s && i<s->rollup[level].n && n<max; i++){
+        b = TS_AT(db, s->rollup[level].offs[i]);
+        if(b->t_first > z){
+            break;
+        }
+        atomic_fetch_add_explicit(&db->touched, 1, memory_order_relaxed);
+        count = b->count;
+        for(j=0; j<count && n<max; j++){
+            if(TS_BUCKET(b)[j].start >= a && TS_BUCKET(b)[j].start <= z){
+                out[n++] = TS_BUCKET(b)[j];
+            }
+        }
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return n;
+}
+
+/*
+ * Min, max, and mean of a series from t0 to t1 (seconds). Blocks wholly inside the range are taken
+ * from their headers and only the blocks at the ends are decoded. Returns -1 if there are no points.
+ */
+int ts_query_summary(TS_DB *db, uint8_t node, uint8_t sensor, double t0, double t1, TS_Summary *out){
+    int64_t a = ts_ms(t0), z = ts_ms(t1);
+    TS_Series *s;
+    TS_Block *b;
+    TS_Iter it;
+    uint32_t i;
+    double sum = 0;
+
+    out->count = 0;
+    out->min = INFINITY;
+    out->max = -INFINITY;
+    pthread_rwlock_rdlock(&db->lock);
+    s = ts_series(db, node, sensor, 0);
+    for(i=(s ? ts_seek(db, &s->raw, a) : 0); s && i<s->raw.n; i++){
+        b = TS_AT(db, s->raw.offs[i]);
+        if(b->t_first > z){
+            break;
+        }
+        if(b->t_first >= a && b->t_last <= z && i + 1 < s->raw.n){  // Newest block's header may be mid-update
+            atomic_fetch_add_explicit(&db->touched, 1, memory_order_relaxed);
+            out->min = (b->min < out->min) ? b->min : out->min;
+            out->max = (b->max > out->max) ? b->max : out->max;
+            sum += b->sum;
+            out->count += b->count;
+            continue;
+        }
+        ts_iter_seek(db, &it, b, a);
+        while(ts_iter_next(db, &it) == 0 && it.m.t <= z){
+            if(it.m.t >= a){
+                out->min = (it.m.v < out->min) ? it.m.v : out->min;
+                out->max = (it.m.v > out->max) ? it.m.v : out->max;
+                sum += it.m.v;
+                out->count++;
+            }
+        }
+    }
+    pthread_rwlock_unlock(&db->lock);
+    if(out->count == 0){
+        return -1;
+    }
+    out->mean = sum / out->count;
+    return 0;
+}
+
+/*
+ * Newest point of a series. Returns -1 if it has none.
+ */
+int ts_latest(TS_DB *db, uint8_t node, uint8_t sensor, TS_Point *out){
+    TS_Series *s;
+    TS_Block *b;
+    int err = -1;
+    pthread_rwlock_rdlock(&db->lock);
+    s = ts_series(db, node, sensor, 0);
+    if(s != NULL && s->raw.n > 0){
+        b = TS_AT(db, s->raw.offs[s->raw.n - 1]);
+        out->time = b->tail.t / 1000.0;
+        out->value = b->tail.v;
+        err = 0;
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return err;
+}
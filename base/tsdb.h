@@ -0,0 +1,144 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Append-only time series store for the base station, one memory mapped file of fixed size blocks.
+ * Every block belongs to one series (a node and sensor pair) and blocks are never moved, only
+ * appended to while they are the newest of their series.
+ *
+ * Raw blocks hold points compressed as in Facebook's Gorilla: timestamps (ms) as delta-of-delta
+ * with variable length prefixes, and values (doubles) as the XOR with the previous value, written as
+ * only its meaningful bits. A sparse index in each block keeps the decoder state every TS_INDEX_EVERY
+ * points so a query can start decoding part way in, and the header keeps the block's time span and
+ * min/max/sum so a block wholly inside a query is answered without decoding it.
+ *
+ * Rollup blocks hold 1 minute, 1 hour, and 1 day buckets of min/max/sum/count, updated as points are
+ * appended, so dashboards get a whole trail's history at a coarse resolution without touching any
+ * raw blocks.
+ *
+ * File layout
+ *  [0]             TS_Header, padded to a block
+ *  [TS_BLOCK..]    Raw and rollup blocks in the order they were started
+ *
+ * Points in a series have to be appended in time order. One process writes; queries in the same
+ * process are safe alongside it, and other processes can open the file read only for a snapshot.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#ifndef TSDB_H_
+#define TSDB_H_
+
+#define TS_MAGIC            "TRAILTS1"
+#define TS_BLOCK            4096
+#define TS_INDEX_EVERY      64          // Points between sparse index marks
+#define TS_INDEX_SLOTS      16          // Marks per block, so at most 1024 points per block
+#define TS_GROW             (16ul << 20)    // File grows this much at a time
+#define TS_MAX_SERIES       (256 * 256)
+#define TS_SERIES(node, sensor)     (((node) << 8) | (sensor))
+
+// Block types
+#define TS_RAW              0x52415754  // "TWAR"
+#define TS_ROLLUP           0x4C4C5254  // "TRLL"
+
+// Rollup levels
+typedef enum TS_LevelEnum{
+    TS_MINUTE,
+    TS_HOUR,
+    TS_DAY,
+    TS_LEVELS
+} TS_Level;
+
+typedef struct TS_HeaderStruct{
+    char magic[8];
+    uint32_t block;                     // TS_BLOCK the file was made with
+    uint32_t pad;
+    uint64_t end;                       // Bytes of blocks in use, a multiple of TS_BLOCK
+} TS_Header;
+
+// Decoder state after a point, so decoding can resume from it
+typedef struct TS_MarkStruct{
+    int64_t t;                          // ms since the epoch
+    double v;
+    int32_t delta;                      // ms from the point before
+    uint16_t bit;                       // Where the next point starts in the data
+    uint8_t lead;                       // Leading and trailing zeros of the last XOR window, 0xFF for none
+    uint8_t trail;
+} TS_Mark;
+
+typedef struct TS_BlockStruct{
+    uint32_t type;
+    uint8_t node;
+    uint8_t sensor;
+    uint8_t level;                      // Rollup level, 0 for raw blocks
+    uint8_t pad;
+    uint32_t count;                     // Points or buckets, written last so readers see whole ones
+    uint32_t pad2;
+    int64_t t_first;                    // ms, first point or first bucket's start
+    int64_t t_last;
+    double min, max, sum;               // Raw blocks only
+    TS_Mark tail;                       // Raw blocks, state after the last point
+    TS_Mark index[TS_INDEX_SLOTS];      // Raw blocks, state after points 0, TS_INDEX_EVERY, ...
+} TS_Block;
+
+#define TS_DATA_SIZE        (TS_BLOCK - sizeof(TS_Block))
+
+typedef struct TS_BucketStruct{
+    int64_t start;                      // ms
+    double min, max, sum;
+    uint32_t count;
+    uint32_t pad;
+} TS_Bucket;
+
+#define TS_BUCKETS          (TS_DATA_SIZE / sizeof(TS_Bucket))
+
+typedef struct TS_PointStruct{
+    double time;                        // Seconds since the epoch
+    double value;
+} TS_Point;
+
+// Summary over a range
+typedef struct TS_SummaryStruct{
+    double min, max, mean;
+    uint64_t count;
+} TS_Summary;
+
+// Offsets of one kind of block of a series, oldest first
+typedef struct TS_ListStruct{
+    uint64_t *offs;
+    uint32_t n, cap;
+} TS_List;
+
+typedef struct TS_SeriesStruct{
+    TS_List raw;
+    TS_List rollup[TS_LEVELS];
+} TS_Series;
+
+typedef struct TS_DBStruct{
+    int fd;
+    int writable;
+    uint8_t *map;
+    uint64_t size;                      // Bytes mapped
+    TS_Series *series[TS_MAX_SERIES];
+    pthread_rwlock_t lock;
+    atomic_uint_fast64_t touched;       // Blocks read by queries, to check they only read what they need
+    atomic_uint_fast64_t decoded;       // Points decoded by queries
+} TS_DB;
+
+int ts_open(TS_DB *db, const char *path, int writable);
+void ts_close(TS_DB *db);
+int ts_sync(TS_DB *db);
+int ts_append(TS_DB *db, uint8_t node, uint8_t sensor, double time, double value);
+int ts_exists(TS_DB *db, uint8_t node, uint8_t sensor);
+long ts_query_raw(TS_DB *db, uint8_t node, uint8_t sensor, double t0, double t1, TS_Point *out, long max);
+long ts_query_rollup(TS_DB *db, uint8_t node, uint8_t sensor, TS_Level level, double t0, double t1, TS_Bucket *out, long max);
+int ts_query_summary(TS_DB *db, uint8_t node, uint8_t sensor, double t0, double t1, TS_Summary *out);
+int ts_latest(TS_DB *db, uint8_t node, uint8_t sensor, TS_Point *out);
+
+#endif /* TSDB_H_ */
@@ -0,0 +1,100 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Range queries against a time series store written by ingestd (tsdb.h), for one node or every node
+ * with a sensor, printed as CSV. The number of blocks read and points decoded goes to stderr.
+ *
+ *  -l raw      every point as node,time,value
+ *  -l minute, hour, or day
+ *              rollup buckets as node,start,min,max,mean,count
+ *  -l summary  one line per node of node,min,max,mean,count (the default)
+ *
+ * usage: tsquery [-s sensor] [-n node] [-l level] [-a hours back | -f from -t to] store.ts
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include "tsdb.h"
+
+#define MAX_OUT             (1 << 20)
+
+static void usage(const char *prog){
+    fprintf(stderr, "usage: %s [-s sensor] [-n node] [-l raw|minute|hour|day|summary] [-a hours back | -f from -t to] store.ts\n", prog);
+}
+
+int main(int argc, char **argv){
+    static TS_DB db;
+    static TS_Point points[MAX_OUT];
+    static TS_Bucket buckets[MAX_OUT];
+    const char *level = "summary";
+    int sensor = 1, node = -1, opt, lo, hi, i;
+    double now = time(NULL), from = now - 48 * 3600.0, to = now;
+    TS_Summary sum;
+    long n, j;
+
+    while((opt = getopt(argc, argv, "s:n:l:a:f:t:")) != -1){
+        switch(opt){
+            case 's': sensor = atoi(optarg); break;
+            case 'n': node = atoi(optarg); break;
+            case 'l': level = optarg; break;
+            case 'a': from = now - atof(optarg) * 3600.0; to = now; break;
+            case 'f': from = atof(optarg); break;
+            case 't': to = atof(optarg); break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if(argc - optind != 1){
+        usage(argv[0]);
+        return 2;
+    }
+    if(ts_open(&db, argv[optind], 0) != 0){
+        fprintf(stderr, "can't open a store at %s\n", argv[optind]);
+        return 1;
+    }
+
+    lo = (node < 0) ? 0 : node;
+    hi = (node < 0) ? 255 : node;
+    for(i=lo; i<=hi; i++){
+        if(!ts_exists(&db, i, sensor)){
+            continue;
+        }
+        if(strcmp(level, "raw") == 0){
+            n = ts_query_raw(&db, i, sensor, from, to, points, MAX_OUT);
+            for(j=0; j<n; j++){
+                printf("%d,%.3f,%g\n", i, points[j].time, points[j].value);
+            }
+        }
+        else if(strcmp(level, "summary") == 0){
+            if(ts_query_summary(&db, i, sensor, from, to, &sum) == 0){
+                printf("%d,%g,%g,%g,%llu\n", i, sum.min, sum.max, sum.mean, (unsigned long long)sum.count);
+            }
+        }
+        else{
+            TS_Level l = (strcmp(level, "minute") == 0) ? TS_MINUTE : (strcmp(level, "hour") == 0) ? TS_HOUR
+                       : (strcmp(level, "day") == 0) ? TS_DAY : TS_LEVELS;
+            if(l == TS_LEVELS){
+                usage(argv[0]);
+                return 2;
+            }
+            n = ts_query_rollup(&db, i, sensor, l, from, to, buckets, MAX_OUT);
+            for(j=0; j<n; j++){
+                printf("%d,%.0f,%g,%g,%g,%u\n", i, buckets[j].start / 1000.0, buckets[j].min, buckets[j].max,
+                       buckets[j].sum / buckets[j].count, buckets[j].count);
+            }
+        }
+    }
+    fprintf(stderr, "%llu blocks read, %llu points decoded\n", (unsigned long long)db.touched, (unsigned long long)db.decoded);
+    ts_close(&db);
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * A small bootloader that applies a firmware update left in the journal by ota_commit(). Each
+ * segment is built into the scratch segment, marked as built, copied over the old segment, and
+ * marked as done. A reset at any point picks up from the journal and finishes the update.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#ifdef __MSP430__
+#include <msp430g2553.h>
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include "flash.h"
+#include "crc.h"
+#include "delta.h"
+#include "ota.h"
+#include "boot.h"
+
+/*
+ * CRC of the image currently in flash, in the layout deltas are made against
+ */
+uint16_t boot_image_crc(void){
+    uint16_t crc = CRC16_INIT, i;
+    uint8_t seg;
+    for(seg=0; seg<OTA_IMAGE_SEGS; seg++){
+        for(i=0; i<FLASH_SEG_SIZE; i++){
+            crc = crc16_update(crc, flash_read(OTA_SEG_ADDR(seg) + i));
+        }
+    }
+    return crc;
+}
+
+/*
+ * Applies a waiting update. Returns 0 if there was nothing to do, 1 if an update was applied, and
+ * -1 if the journal or delta is bad, in which case the journal is cleared and the image left alone
+ * wherever it got to.
+ */
+int boot_apply(void){
+    DELTA_Stream s;
+    uint16_t len, crc, i, dst;
+    uint8_t seg;
+
+    if((flash_read(OTA_JOURNAL_BASE + OTA_J_MAGIC) | (flash_read(OTA_JOURNAL_BASE + OTA_J_MAGIC + 1) << 8)) != OTA_MAGIC){
+        return 0;
+    }
+    len = flash_read(OTA_JOURNAL_BASE + OTA_J_LEN) | (flash_read(OTA_JOURNAL_BASE + OTA_J_LEN + 1) << 8);
+    crc = flash_read(OTA_JOURNAL_BASE + OTA_J_CRC) | (flash_read(OTA_JOURNAL_BASE + OTA_J_CRC + 1) << 8);
+    if(delta_open(&s, OTA_STAGING_BASE, len) != 0 || s.new_crc != crc){
+        flash_erase(OTA_JOURNAL_BASE);
+        return -1;
+    }
+
+    for(seg=0; seg<OTA_IMAGE_SEGS; seg++){
+        if(flash_read(OTA_JOURNAL_BASE + OTA_J_DONE + seg) == 0){
+            delta_segment(&s, seg, 0, NULL);        // Skip over this segment's ops
+            continue;
+        }
+        if(flash_read(OTA_JOURNAL_BASE + OTA_J_BUILT + seg) != 0){
+            flash_erase(OTA_SCRATCH_BASE);
+            if(delta_segment(&s, seg, OTA_SCRATCH_BASE, NULL) != 0){
+                flash_erase(OTA_JOURNAL_BASE);
+                return -1;
+            }
+            flash_write_byte(OTA_JOURNAL_BASE + OTA_J_BUILT + seg, 0);
+        }
+        else{
+            delta_segment(&s, seg, 0, NULL);        // Scratch already holds it from before a reset
+        }
+
+        dst = OTA_SEG_ADDR(seg);
+        flash_erase(dst);
+        flash_write_byte(dst + FLASH_SEG_SIZE - 2, flash_read(OTA_SCRATCH_BASE + FLASH_SEG_SIZE - 2));
+        flash_write_byte(dst + FLASH_SEG_SIZE - 1, flash_read(OTA_SCRATCH_BASE + FLASH_SEG_SIZE - 1));
+        for(i=0; i<FLASH_SEG_SIZE-2; i++){          // Reset vector first to keep the window without one short
+            flash_write_byte(dst + i, flash_read(OTA_SCRATCH_BASE + i));
+        }
+        flash_write_byte(OTA_JOURNAL_BASE + OTA_J_DONE + seg, 0);
+    }
+
+    flash_erase(OTA_JOURNAL_BASE);
+    if(boot_image_crc() != s.new_crc){      // Covers segments built before a reset too
+        return -1;
+    }
+    return 1;
+}
+
+#ifdef __MSP430__
+/*
+ * Reset entry point. Runs before the C startup, so only the stack pointer is set up before applying
+ * any waiting update and jumping to the application's C startup through OTA_APP_ENTRY.
+ */
+void boot_entry(void){
+    __set_SP_register(0x0400);              // Top of RAM
+    WDTCTL = WDTPW | WDTHOLD;
+    flash_init(1);                          // DCO is at its ~1 MHz reset default
+    boot_apply();
+    ((void (*)(void))(*(const uint16_t *)OTA_APP_ENTRY))();
+}
+
+// Reset vector and application entry word, placed by the linker command file
+#if defined(__TI_COMPILER_VERSION__)
+extern void _c_int00(void);
+#pragma DATA_SECTION(boot_reset_vector, ".reset")
+void (* const boot_reset_vector)(void) = boot_entry;
+#pragma DATA_SECTION(boot_app_entry, ".app_entry")
+void (* const boot_app_entry)(void) = _c_int00;
+#elif defined(__GNUC__)
+extern void _start(void);
+void (* const boot_reset_vector)(void) __attribute__ ((section(".resetvec"))) = boot_entry;
+void (* const boot_app_entry)(void) __attribute__ ((section(".app_entry"))) = _start;
+#else
+#error Compiler not supported!
+#endif
+#endif
@@ -0,0 +1,23 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * A small bootloader that applies a firmware update left in the journal by ota_commit(). It lives in
+ * its own flash section (see ota.h) that updates never touch, and owns the reset vector.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+
+#ifndef BOOT_H_
+#define BOOT_H_
+
+int boot_apply(void);
+uint16_t boot_image_crc(void);
+
+#endif /* BOOT_H_ */
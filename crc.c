@@ -0,0 +1,38 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * CRC-16-CCITT, see crc.h
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+#include "crc.h"
+
+static const uint16_t crc_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+/*
+ * Adds one byte to a running CRC. Start from CRC16_INIT.
+ */
+uint16_t crc16_update(uint16_t crc, uint8_t byte){
+    crc = (crc << 4) ^ crc_table[(crc >> 12) ^ (byte >> 4)];
+    crc = (crc << 4) ^ crc_table[(crc >> 12) ^ (byte & 0x0F)];
+    return crc;
+}
+
+uint16_t crc16(const uint8_t *buf, uint16_t len){
+    uint16_t crc = CRC16_INIT;
+    uint16_t i;
+    for(i=0; i<len; i++){
+        crc = crc16_update(crc, buf[i]);
+    }
+    return crc;
+}
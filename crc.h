@@ -0,0 +1,26 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * CRC-16-CCITT (0x1021, initial value 0xFFFF) computed a nibble at a time so the table is only 32
+ * bytes. Used for the frames on the air and for checking firmware images, so it is kept apart from
+ * fec.c to let the bootloader link it without the Reed-Solomon tables.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+
+#ifndef CRC_H_
+#define CRC_H_
+
+#define CRC16_INIT  0xFFFF
+
+uint16_t crc16(const uint8_t *buf, uint16_t len);
+uint16_t crc16_update(uint16_t crc, uint8_t byte);
+
+#endif /* CRC_H_ */
@@ -0,0 +1,120 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Applying compressed binary deltas between firmware images, see delta.h for the format. This file
+ * is linked into the bootloader section (see ota.h).
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "flash.h"
+#include "crc.h"
+#include "ota.h"
+#include "delta.h"
+
+static uint16_t delta_u16(DELTA_Stream *s){
+    uint16_t v = flash_read(s->addr) | ((uint16_t)flash_read(s->addr + 1) << 8);
+    s->addr += 2;
+    return v;
+}
+
+/*
+ * Reads the header of a delta stored at addr. Returns -1 if it isn't a delta for this image layout.
+ */
+int delta_open(DELTA_Stream *s, uint16_t addr, uint16_t len){
+    if(len < DELTA_HDR_SIZE){
+        return -1;
+    }
+    s->addr = addr;
+    s->end = addr + len;
+    if(delta_u16(s) != DELTA_MAGIC || flash_read(s->addr) != DELTA_VERSION){
+        return -1;
+    }
+    s->segs = flash_read(s->addr + 1);
+    s->addr += 2;
+    s->old_crc = delta_u16(s);
+    s->new_crc = delta_u16(s);
+    if(s->segs != OTA_IMAGE_SEGS){
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Builds segment seg of the new image at out, which must be erased, and adds it to *crc unless crc
+ * is NULL. Segments must be built in order since the ops for each follow the last. If out is 0 the
+ * ops are only skipped over. Returns -1 if the ops are malformed.
+ */
+int delta_segment(DELTA_Stream *s, uint8_t seg, uint16_t out, uint16_t *crc){
+    uint16_t pos = 0, len, src, i;
+    uint8_t op, value = 0;
+
+    while(pos < FLASH_SEG_SIZE){
+        if(s->addr >= s->end){
+            return -1;
+        }
+        op = flash_read(s->addr++);
+        len = (op & 0x3F) + 1;
+        if(len == 64){
+            len += flash_read(s->addr++);
+        }
+        if(pos + len > FLASH_SEG_SIZE){
+            return -1;
+        }
+
+        switch(op & 0xC0){
+            case DELTA_LITERAL:
+                src = s->addr;
+                s->addr += len;
+                break;
+            case DELTA_COPY_OLD:
+                src = delta_u16(s);
+                if(src < (uint16_t)seg*FLASH_SEG_SIZE || src + len > OTA_IMAGE_SIZE){
+                    return -1;                  // Old segments before this one are already gone
+                }
+                break;
+            case DELTA_COPY_NEW:
+                src = delta_u16(s);
+                if(src >= pos){
+                    return -1;
+                }
+                break;
+            default:                            // DELTA_FILL
+                value = flash_read(s->addr++);
+                src = 0;
+                break;
+        }
+        if(s->addr > s->end){
+            return -1;
+        }
+
+        for(i=0; i<len; i++){
+            switch(op & 0xC0){
+                case DELTA_LITERAL:
+                    value = flash_read(src + i);
+                    break;
+                case DELTA_COPY_OLD:
+                    value = flash_read(OTA_SEG_ADDR((src + i) / FLASH_SEG_SIZE) + (src + i) % FLASH_SEG_SIZE);
+                    break;
+                case DELTA_COPY_NEW:
+                    value = (out != 0) ? flash_read(out + src + i) : 0;
+                    break;
+            }
+            if(out != 0){
+                flash_write_byte(out + pos + i, value);
+                if(crc != NULL){
+                    *crc = crc16_update(*crc, value);
+                }
+            }
+        }
+        pos += len;
+    }
+    return 0;
+}
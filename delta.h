@@ -0,0 +1,58 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Compressed binary deltas between firmware images (see ota.h for the image layout). A delta is
+ * applied one 512 byte segment at a time, in order, into a scratch segment that is then copied over
+ * the old one. Ops may only copy from old segments that haven't been replaced yet (the current one
+ * and those after it), which is what lets the update run in place with no second image in flash.
+ *
+ * Delta layout
+ *  [0..1]  DELTA_MAGIC
+ *  [2]     Version
+ *  [3]     Number of segments
+ *  [4..5]  CRC of the image the delta was made against
+ *  [6..7]  CRC of the image the delta produces
+ *  [8..]   Ops, each segment's ops produce exactly 512 bytes
+ *
+ * Op byte is TTLLLLLL, type T and length L+1. L = 63 means the length is 64 plus the next byte.
+ *  LITERAL     length bytes follow
+ *  COPY_OLD    2 byte old image offset follows
+ *  COPY_NEW    2 byte offset into the segment being built follows (LZ77 style, may overlap)
+ *  FILL        1 byte value follows
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+
+#ifndef DELTA_H_
+#define DELTA_H_
+
+#define DELTA_MAGIC         0x4454          // "TD"
+#define DELTA_VERSION       1
+#define DELTA_HDR_SIZE      8
+#define DELTA_MAX_LEN       (64 + 255)
+
+// Op types
+#define DELTA_LITERAL       0x00
+#define DELTA_COPY_OLD      0x40
+#define DELTA_COPY_NEW      0x80
+#define DELTA_FILL          0xC0
+
+typedef struct DELTA_StreamStruct{
+    uint16_t addr;                          // Flash address of the next op
+    uint16_t end;
+    uint8_t segs;
+    uint16_t old_crc;
+    uint16_t new_crc;
+} DELTA_Stream;
+
+int delta_open(DELTA_Stream *s, uint16_t addr, uint16_t len);
+int delta_segment(DELTA_Stream *s, uint8_t seg, uint16_t out, uint16_t *crc);
+
+#endif /* DELTA_H_ */
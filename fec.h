@@ -0,0 +1,43 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * CRC and forward error correction for frames on the air. A frame is always the full 32 byte nRF24
+ * payload and is a shortened Reed-Solomon codeword over GF(256):
+ *
+ *  [0]             FEC level code, so the receiver knows how much parity follows
+ *  [1..k]          Data (a packet.h frame), zero padded to k = fec_capacity(level)
+ *  [k+1..k+2]      CRC-16-CCITT (crc.h) over bytes 0 to k
+ *  [k+3..31]       Reed-Solomon parity, FEC_NSYM(level) bytes
+ *
+ * Level 0 has no parity and only the CRC. Each level above adds 4 parity bytes, which corrects 2
+ * more corrupted bytes per frame. Only the encoder is here; the decoder runs on the base station.
+ * Frames sent to the nodes are always level 0 so a node only has to check the CRC.
+ * No MSP430 specific headers are used here so the base station can build it as is.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+
+#ifndef FEC_H_
+#define FEC_H_
+
+#define FEC_FRAME_SIZE      32
+#define FEC_LEVELS          4
+#define FEC_NSYM(level)     ((level)*4)                         // Parity bytes at a level
+#define FEC_MAX_NSYM        FEC_NSYM(FEC_LEVELS-1)
+
+extern const uint8_t fec_exp[255];
+extern const uint8_t fec_log[256];
+extern const uint8_t fec_level_code[FEC_LEVELS];
+
+uint8_t fec_capacity(uint8_t level);
+int fec_encode(uint8_t level, const uint8_t *data, uint8_t len, uint8_t *frame);
+int fec_check(const uint8_t *frame);
+
+#endif /* FEC_H_ */
@@ -0,0 +1,75 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Self programming of the MSP430G2553 flash. This file is linked into the bootloader section (see
+ * ota.h) so that it is never rewritten by a firmware update.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <msp430g2553.h>
+#include <stdint.h>
+#include "flash.h"
+
+/*
+ * Sets the flash timing generator from MCLK. It must run between 257 and 476 kHz, so MCLK is divided
+ * down to ~400 kHz (333 kHz at 1 MHz). Call again whenever the DCO changes.
+ */
+int flash_init(uint8_t mclk_mhz){
+    uint8_t div = (mclk_mhz*5 + 1)/2;
+    if(div == 0 || div > 64){
+        return -1;
+    }
+    FCTL2 = FWKEY + FSSEL_1 + (div - 1);    // MCLK divided by div
+    return 0;
+}
+
+/*
+ * Erases the segment containing addr. The CPU is held while the erase runs (~12 ms).
+ */
+int flash_erase(uint16_t addr){
+    __istate_t gie = __get_interrupt_state();
+    __disable_interrupt();
+    while(FCTL3 & BUSY);
+    FCTL3 = FWKEY;                          // Unlock, leaving info segment A locked
+    FCTL1 = FWKEY + ERASE;
+    *(volatile uint8_t *)addr = 0;          // Dummy write starts the erase
+    while(FCTL3 & BUSY);
+    FCTL1 = FWKEY;
+    FCTL3 = FWKEY + LOCK;
+    __set_interrupt_state(gie);
+    return 0;
+}
+
+int flash_write_byte(uint16_t addr, uint8_t value){
+    return flash_write(addr, &value, 1);
+}
+
+/*
+ * Writes len bytes starting at addr. The bytes must already be erased.
+ */
+int flash_write(uint16_t addr, const uint8_t *data, uint16_t len){
+    uint16_t i;
+    __istate_t gie = __get_interrupt_state();
+    __disable_interrupt();
+    while(FCTL3 & BUSY);
+    FCTL3 = FWKEY;
+    FCTL1 = FWKEY + WRT;
+    for(i=0; i<len; i++){
+        *(volatile uint8_t *)(addr + i) = data[i];
+        while(FCTL3 & BUSY);
+    }
+    FCTL1 = FWKEY;
+    FCTL3 = FWKEY + LOCK;
+    __set_interrupt_state(gie);
+    return 0;
+}
+
+uint8_t flash_read(uint16_t addr){
+    return *(const volatile uint8_t *)addr;
+}
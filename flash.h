@@ -0,0 +1,33 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Self programming of the MSP430G2553 flash. Addresses are 16 bit flash addresses rather than
+ * pointers so code using this library (ota.c, delta.c, boot.c) can also run on a PC against a RAM
+ * copy of the flash.
+ *
+ * Main flash segments are 512 bytes and info flash segments are 64 bytes. Writes can only clear
+ * bits, so a segment has to be erased before it is rewritten.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+
+#ifndef FLASH_H_
+#define FLASH_H_
+
+#define FLASH_SEG_SIZE      512
+#define FLASH_INFO_SIZE     64
+
+int flash_init(uint8_t mclk_mhz);
+int flash_erase(uint16_t addr);
+int flash_write_byte(uint16_t addr, uint8_t value);
+int flash_write(uint16_t addr, const uint8_t *data, uint16_t len);
+uint8_t flash_read(uint16_t addr);
+
+#endif /* FLASH_H_ */
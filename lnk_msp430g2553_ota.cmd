@@ -0,0 +1,116 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Linker command file for the MSP430G2553 with over the air updates, in place of the CCS default
+ * lnk_msp430g2553.cmd. Follows the flash layout in ota.h: the application with its entry word at
+ * 0xC000, staging and scratch left empty, and the bootloader at 0xFA00.
+ *
+ * Everything the bootloader runs has to be in its section, since it runs while the application
+ * segments are half written. That is boot.c, flash.c, delta.c, and crc.c, and the runtime helpers
+ * the compiler calls from them: the __mspabi_* multiply, divide, and shift routines (the G2553 has
+ * no hardware multiplier or barrel shifter) and memcpy/memset for struct copies and initialisers.
+ * The application calls the same copies. make -C base bootcheck OUT=<image>.out checks that nothing
+ * the bootloader calls was left outside its section.
+ *
+ * The bootloader section is never updated, and the application calls into it, so it has to link to
+ * the same bytes in every image sent as an update. Keep the compiler version and options the same;
+ * otadelta refuses to make a delta between images whose bootloader sections differ.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+--stack_size=80
+--heap_size=0
+
+MEMORY
+{
+    SFR                     : origin = 0x0000, length = 0x0010
+    PERIPHERALS_8BIT        : origin = 0x0010, length = 0x00F0
+    PERIPHERALS_16BIT       : origin = 0x0100, length = 0x0100
+    RAM                     : origin = 0x0200, length = 0x0200
+    INFOA                   : origin = 0x10C0, length = 0x0040
+    INFOB                   : origin = 0x1080, length = 0x0040
+    INFOC                   : origin = 0x1040, length = 0x0040
+    INFOD                   : origin = 0x1000, length = 0x0040      // Update journal, OTA_JOURNAL_BASE
+    APP_ENTRY               : origin = 0xC000, length = 0x0002      // OTA_APP_ENTRY
+    FLASH                   : origin = 0xC002, length = 0x29FE
+    STAGING                 : origin = 0xEA00, length = 0x0E00      // OTA_STAGING_BASE, nothing placed
+    SCRATCH                 : origin = 0xF800, length = 0x0200      // OTA_SCRATCH_BASE, nothing placed
+    BOOT                    : origin = 0xFA00, length = 0x0400      // OTA_BOOT_BASE
+    VECT_SEG                : origin = 0xFE00, length = 0x01E0      // Rest of the vector segment, part of the image
+    INT00                   : origin = 0xFFE0, length = 0x0002
+    INT01                   : origin = 0xFFE2, length = 0x0002
+    INT02                   : origin = 0xFFE4, length = 0x0002
+    INT03                   : origin = 0xFFE6, length = 0x0002
+    INT04                   : origin = 0xFFE8, length = 0x0002
+    INT05                   : origin = 0xFFEA, length = 0x0002
+    INT06                   : origin = 0xFFEC, length = 0x0002
+    INT07                   : origin = 0xFFEE, length = 0x0002
+    INT08                   : origin = 0xFFF0, length = 0x0002
+    INT09                   : origin = 0xFFF2, length = 0x0002
+    INT10                   : origin = 0xFFF4, length = 0x0002
+    INT11                   : origin = 0xFFF6, length = 0x0002
+    INT12                   : origin = 0xFFF8, length = 0x0002
+    INT13                   : origin = 0xFFFA, length = 0x0002
+    INT14                   : origin = 0xFFFC, length = 0x0002
+    RESET                   : origin = 0xFFFE, length = 0x0002
+}
+
+SECTIONS
+{
+    // Bootloader first, so its objects and helpers aren't taken by the .text and .const below
+    .boot :
+    {
+        boot.obj(.text, .const)
+        flash.obj(.text, .const)
+        delta.obj(.text, .const)
+        crc.obj(.text, .const)
+        *rts430*.lib<*>(.text:__mspabi_*)
+        *rts430*.lib<*>(.text:memcpy, .text:memset)
+    } > BOOT
+
+    .app_entry  : {} > APP_ENTRY            // boot_app_entry, the address of _c_int00
+    .reset      : {} > RESET                // boot_reset_vector, always boot_entry
+
+    .bss        : {} > RAM
+    .data       : {} > RAM
+    .sysmem     : {} > RAM
+    .stack      : {} > RAM (HIGH)
+
+    .text       : {} > FLASH
+    .text:_isr  : {} > FLASH
+    .cinit      : {} > FLASH
+    .const      : {} > FLASH
+    .init_array : {} > FLASH
+    .binit      : {} > FLASH
+    .pinit      : {} > FLASH
+    .cio        : {} > RAM
+
+    // INFOD is left to ota.c, the other info segments are free
+    .infoA      : {} > INFOA
+    .infoB      : {} > INFOB
+    .infoC      : {} > INFOC
+
+    TRAPINT      : { * ( .int00 ) } > INT00 type = VECT_INIT
+    .int01       : {} > INT01
+    PORT1        : { * ( .int02 ) } > INT02 type = VECT_INIT
+    PORT2        : { * ( .int03 ) } > INT03 type = VECT_INIT
+    .int04       : {} > INT04
+    ADC10        : { * ( .int05 ) } > INT05 type = VECT_INIT
+    USCIAB0TX    : { * ( .int06 ) } > INT06 type = VECT_INIT
+    USCIAB0RX    : { * ( .int07 ) } > INT07 type = VECT_INIT
+    TIMER0_A1    : { * ( .int08 ) } > INT08 type = VECT_INIT
+    TIMER0_A0    : { * ( .int09 ) } > INT09 type = VECT_INIT
+    WDT          : { * ( .int10 ) } > INT10 type = VECT_INIT
+    COMPARATORA  : { * ( .int11 ) } > INT11 type = VECT_INIT
+    TIMER1_A1    : { * ( .int12 ) } > INT12 type = VECT_INIT
+    TIMER1_A0    : { * ( .int13 ) } > INT13 type = VECT_INIT
+    NMI          : { * ( .int14 ) } > INT14 type = VECT_INIT
+}
+
+-l msp430g2553.cmd
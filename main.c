@@ -1,7 +1,7 @@
 /*
  * Author: Evan Jones III
  * Initial Commit: 10/28/2025
- * Last Commit: 11/26/2025
+ * Last Commit: 10/19/2026
  *
  * A wireless sensor network for measuring trail conditions of a nordic ski trail
  * For a detailed explanation, see README.md
@@ -16,34 +16,277 @@
 #include "adc.h"
 #include "usci.h"
 #include "sensors.h"
+#include "power.h"
+#include "radio.h"
+#include "packet.h"
+#include "fec.h"
+#include "flash.h"
+#include "ota.h"
+#include "sample.h"
+#include "seq.h"
+
+#ifndef NODE_ID
+#define NODE_ID         0x01                    // The simulator gives every node its own
+#endif
+#define ENERGY_EVERY    6                       // Reports between energy summaries
+#define GW_UART_US      3300                    // A frame and its serial framing (37 bytes) over the gateway's 115200 baud UART
+#define GW_ANSWER_US    1000                    // Base station decoding a report and answering
+#define RX_WINDOW_TICKS (PWR_ACLK_HZ * (3ul*GW_UART_US + GW_ANSWER_US + 1000) / 1000000)  // Report up, FEC change and resend request down
+#define OTA_POLL_TICKS  (PWR_ACLK_HZ/1000)      // Radio FIFO check interval during a firmware update
+#define OTA_IDLE_TICKS  (2ul*PWR_ACLK_HZ)       // Give up on an update after 2 s of silence, it can resume later
+
+uint8_t fec_level = FEC_LEVELS-1;               // Start robust, the base station lowers it for good links
+uint8_t ota_session = 0;                        // Stay listening after the report for a firmware update
+uint8_t resend_first = 0;                       // Reports the base station asked for again, see PKT_CMD_RESEND
+uint8_t resend_mask = 0;
+
+// Sensors and their adaptive sampling, see sample.h
+#define NUM_SENSORS     2
+const uint8_t sensor_ids[NUM_SENSORS] = {PKT_SEN_TEMP, PKT_SEN_DEPTH};
+SMP_Sensor sampling[NUM_SENSORS];
+uint8_t send_bounds = 1;                        // Report the sampling bounds at boot and when they change
+
+/*
+ * Reads a sensor by index into sensor_ids. Returns -1 if the reading failed.
+ */
+int read_sensor(uint8_t i, int16_t *value){
+    int v;
+    switch(sensor_ids[i]){
+        case PKT_SEN_TEMP:
+            *value = temperature();
+            return 0;
+        case PKT_SEN_DEPTH:
+            v = snow_depth();
+            *value = v;
+            return (v < 0) ? -1 : 0;
+    }
+    return -1;
+}
+
+/*
+ * Encodes a frame at the current FEC level and sends it. A kept report built while the level was
+ * lower may not fit any more, so it goes at the highest level that still holds it.
+ */
+void send_frame(PKT_Frame *pkt){
+    uint8_t air[FEC_FRAME_SIZE];
+    uint8_t level = fec_level;
+    while(level > 0 && fec_capacity(level) < pkt->len){
+        level--;
+    }
+    fec_encode(level, pkt->buf, pkt->len, air);
+    radio_send((char *)air, FEC_FRAME_SIZE);
+}
+
+/*
+ * Numbers a report and keeps it in case the base station misses it, then sends it
+ */
+void send_report(PKT_Frame *pkt){
+    seq_stamp(pkt);
+    send_frame(pkt);
+}
+
+/*
+ * Sends the kept reports the base station asked for, oldest first. Ones already overwritten are
+ * skipped, the base station stops asking once they're too old.
+ */
+void send_resends(void){
+    PKT_Frame *pkt;
+    uint8_t i;
+    for(i=0; i<8; i++){
+        if((resend_mask & (1 << i)) && (pkt = seq_find(resend_first + i)) != 0){
+            pkt->buf[1] |= PKT_F_RESENT;
+            send_frame(pkt);
+        }
+    }
+    resend_mask = 0;
+}
+
+/*
+ * Tells the base station how far a firmware update has gotten and goes back to listening
+ */
+void send_ota_status(void){
+    PKT_Frame pkt;
+    uint8_t status[OTA_STATUS_SIZE];
+    ota_status(status);
+    pkt_init(&pkt, NODE_ID, PKT_OTA_STATUS, status, OTA_STATUS_SIZE);
+    send_frame(&pkt);
+    radio_listen();
+}
+
+/*
+ * Sends the minimum and maximum sampling period of every sensor
+ */
+void send_sampling_bounds(void){
+    PKT_Frame pkt;
+    uint8_t i;
+    pkt_report_init(&pkt, NODE_ID, fec_capacity(fec_level));
+    for(i=0; i<NUM_SENSORS; i++){
+        pkt_report_add(&pkt, PKT_SEN_MIN | sensor_ids[i], sampling[i].min_period);
+        pkt_report_add(&pkt, PKT_SEN_MAX | sensor_ids[i], sampling[i].max_period);
+    }
+    send_report(&pkt);
+    send_bounds = 0;
+}
+
+/*
+ * Acts on a frame from the base station. Only level 0 frames addressed to this node are accepted.
+ */
+void handle_control(const uint8_t *frame){
+    uint8_t cmd;
+    const uint8_t *args;
+    int nargs;
+    if(fec_check(frame) != 0 || frame[1] != NODE_ID){
+        return;
+    }
+    nargs = pkt_control_parse(&frame[1], fec_capacity(0), &cmd, &args);
+    if(nargs < 0){
+        return;
+    }
+    switch(cmd){
+        case PKT_CMD_FEC:
+            if(nargs == 1 && args[0] < FEC_LEVELS){
+                fec_level = args[0];
+            }
+            break;
+        case PKT_CMD_OTA_BEGIN:
+            if(nargs == 4){
+                ota_begin(args[0] | (args[1] << 8), args[2] | (args[3] << 8));
+                ota_session = 1;
+                send_ota_status();              // Says where to resume from if this is a retry
+            }
+            break;
+        case PKT_CMD_OTA_DATA:
+            if(nargs > 2){
+                ota_chunk(args[0] | (args[1] << 8), &args[2], nargs - 2);
+            }
+            break;
+        case PKT_CMD_OTA_QUERY:
+            send_ota_status();
+            break;
+        case PKT_CMD_OTA_COMMIT:
+            if(ota_commit() == 0){
+                radio_power_down();
+                WDTCTL = 0;                     // Bad watchdog password resets into the bootloader
+            }
+            send_ota_status();
+            break;
+        case PKT_CMD_SAMPLING:
+            if(nargs == 11){
+                uint8_t i;
+                for(i=0; i<NUM_SENSORS; i++){
+                    if(sensor_ids[i] == args[0]){
+                        smp_init(&sampling[i], args[1] | (args[2] << 8), args[3] | (args[4] << 8),
+                                 args[5] | (args[6] << 8), (int16_t)(args[7] | (args[8] << 8)), args[9] | (args[10] << 8));
+                        send_bounds = 1;
+                    }
+                }
+            }
+            break;
+        case PKT_CMD_RESEND:
+            if(nargs == 2){
+                resend_first = args[0];         // Sent once the listen window is over
+                resend_mask = args[1];
+            }
+            break;
+    }
+}
+
+/*
+ * Serves a firmware update until the base station goes quiet
+ */
+void ota_listen(void){
+    uint8_t air[FEC_FRAME_SIZE];
+    uint32_t idle = 0;
+    while(idle < OTA_IDLE_TICKS){
+        power_sleep(OTA_POLL_TICKS);
+        if(radio_read((char *)air) == 0){
+            handle_control(air);
+            idle = 0;
+        }
+        else{
+            idle += OTA_POLL_TICKS;
+        }
+    }
+    ota_session = 0;
+}
 
 int main(void)
 {
 	WDTCTL = WDTPW | WDTHOLD;	// stop watchdog timer
 	
 	// Set up MCLK and SMCLK for a base speed of 16 MHz and ACLK to use the 32 kHz XTAL
-	DCOCTL = 0x00;          // Stop clock before changing system
 	BCSCTL3 = LFXT1S_2;     // Set LFXT1 to 32k XTAL TODO: Solder 32k XTAL to board and switch from VLO to 32k
 	BCSCTL2 = 0x00;         // MCLK is set to DCO with no division
-	BCSCTL1 = CALBC1_16MHZ; // Set DCO to 16 MHz
-	DCOCTL = CALDCO_16MHZ;
+	power_set_dco(PWR_DCO_MHZ);    // Set DCO to 16 MHz
+	power_init();           // Start energy accounting on Timer0_A
+	flash_init(16);         // Flash timing generator for OTA updates
 
 
 	// TODO: Init ports
 	adc_single_init(4);
-	P2DIR = BIT3;           // Enables the nRF24
-	P2OUT = BIT3;
-	//char samp_array[5] = {0x43,0x22,0x44,0x19,0xFF};
-	char samp_array[5] = {0};
-	// TODO: Init sensors
+	PKT_Frame pkt;
+	PKT_Frame energy;                                   // Report of its own for a summary that didn't fit
+	uint8_t summary[PWR_SUMMARY_SIZE];
+	uint8_t reports = 0;
+	uint8_t air[FEC_FRAME_SIZE];
+	uint8_t due, i;
+	uint16_t next;
+	int16_t value;
+	snow_depth_init();
+	smp_init(&sampling[0], 300, 3600, 2, 0, 2);         // Temp 5 min to 1 h, fast at 2 C/h or within 2 C of freezing
+	smp_init(&sampling[1], 600, 14400, 20, 0, SMP_NO_BAND); // Depth 10 min to 4 h, fast at 20 mm/h of snowfall
+	due = smp_elapse(sampling, NUM_SENSORS, 0);         // Everything is due at boot
 
 
 	// TODO: Init wireless network
     B0_spi_init();             // Init SPI peripheral
     while(1){
-        //__delay_cycles(10000);
-        __no_operation();
-        B0_spi_receive(0x06,&samp_array[0],2);           // Read nRF24 status to check for operation
+        pkt_report_init(&pkt, NODE_ID, fec_capacity(fec_level));
+        for(i=0; i<NUM_SENSORS; i++){
+            if(!(due & (1 << i))){
+                continue;
+            }
+            if(read_sensor(i, &value) == 0){
+                pkt_report_add(&pkt, sensor_ids[i], value);
+                smp_update(&sampling[i], value);
+            }
+            else{
+                sampling[i].wait = sampling[i].period;      // Try again next period, keep the rate
+            }
+            pkt_report_add(&pkt, PKT_SEN_PERIOD | sensor_ids[i], sampling[i].period);
+        }
+        energy.len = 0;
+        if(++reports >= ENERGY_EVERY){                  // Piggyback energy use on every few reports
+            reports = 0;
+            power_summary(summary);                     // Starts a new interval, so the summary has to go out
+            if(pkt_report_energy(&pkt, summary) != 0){  // No room left at this FEC level
+                pkt_report_init(&energy, NODE_ID, fec_capacity(fec_level));
+                pkt_report_energy(&energy, summary);
+            }
+        }
+        radio_init();                                   // Radio only comes up once the sensors are read
+        send_report(&pkt);
+        if(energy.len > 0){
+            send_report(&energy);
+        }
+        if(send_bounds){
+            send_sampling_bounds();
+        }
+        radio_listen();                                 // Brief window for the base station to answer
+        power_sleep(RX_WINDOW_TICKS);
+        while(radio_read((char *)air) == 0){            // An FEC change and a resend request can both be waiting
+            handle_control(air);
+        }
+        if(ota_session){
+            ota_listen();
+        }
+        if(resend_mask){
+            send_resends();
+        }
+        radio_power_down();
+        next = smp_next(sampling, NUM_SENSORS);         // Sleep until the next sensor is due
+        power_sleep((uint32_t)next * PWR_ACLK_HZ);
+        due = smp_elapse(sampling, NUM_SENSORS, next);
     }
 	// TODO: Init interrupts and LPM
     //__no_operation();
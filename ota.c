@@ -0,0 +1,160 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Receiving over the air firmware updates into the staging area, see ota.h
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+#include "flash.h"
+#include "crc.h"
+#include "delta.h"
+#include "ota.h"
+#include "boot.h"
+
+// Global Variables
+OTA_State ota = OTA_IDLE;
+uint16_t ota_len = 0;                       // Length and CRC the delta was announced with
+uint16_t ota_crc = 0;
+uint16_t ota_chunks = 0;
+uint16_t ota_received = 0;
+uint8_t ota_have[(OTA_MAX_CHUNKS + 7) / 8]; // Bit per chunk written to staging
+
+/*
+ * Starts receiving a delta. If the same delta is already partly received the transfer resumes
+ * where it left off, otherwise the staging area is erased.
+ */
+int ota_begin(uint16_t len, uint16_t crc){
+    uint16_t i;
+    if(len < DELTA_HDR_SIZE || len > OTA_STAGING_SIZE){
+        return -1;
+    }
+    if((ota == OTA_RECEIVING || ota == OTA_COMPLETE) && len == ota_len && crc == ota_crc){
+        return 0;
+    }
+    for(i=0; i<len; i+=FLASH_SEG_SIZE){
+        flash_erase(OTA_STAGING_BASE + i);
+    }
+    for(i=0; i<sizeof(ota_have); i++){
+        ota_have[i] = 0;
+    }
+    ota_len = len;
+    ota_crc = crc;
+    ota_chunks = (len + OTA_CHUNK - 1) / OTA_CHUNK;
+    ota_received = 0;
+    ota = OTA_RECEIVING;
+    return 0;
+}
+
+/*
+ * Writes one chunk of the delta to staging. Repeats of a chunk that is already in are ignored.
+ */
+int ota_chunk(uint16_t index, const uint8_t *data, uint8_t len){
+    uint16_t offset = index * OTA_CHUNK;
+    if(ota != OTA_RECEIVING || index >= ota_chunks){
+        return -1;
+    }
+    if(len != ((index == ota_chunks - 1) ? ota_len - offset : OTA_CHUNK)){
+        return -1;
+    }
+    if(ota_have[index >> 3] & (1 << (index & 7))){
+        return 0;
+    }
+    flash_write(OTA_STAGING_BASE + offset, data, len);
+    ota_have[index >> 3] |= 1 << (index & 7);
+    if(++ota_received == ota_chunks){
+        ota = OTA_COMPLETE;
+    }
+    return 0;
+}
+
+/*
+ * Writes OTA_STATUS_SIZE bytes describing the transfer to buf so the base station knows what to send
+ *
+ * buf[0] OTA_State
+ * buf[1..2] chunks received
+ * buf[3..4] first missing chunk (ota_chunks if none are missing)
+ * buf[5..12] bitmap of the OTA_STATUS_WINDOW chunks from the first missing one, 1 if received
+ */
+int ota_status(uint8_t *buf){
+    uint16_t first = 0, i, c;
+    while(first < ota_chunks && (ota_have[first >> 3] & (1 << (first & 7)))){
+        first++;
+    }
+    buf[0] = ota;
+    buf[1] = ota_received & 0xFF;
+    buf[2] = ota_received >> 8;
+    buf[3] = first & 0xFF;
+    buf[4] = first >> 8;
+    for(i=0; i<OTA_STATUS_WINDOW/8; i++){
+        buf[5+i] = 0;
+    }
+    for(i=0; i<OTA_STATUS_WINDOW; i++){
+        c = first + i;
+        if(c < ota_chunks && (ota_have[c >> 3] & (1 << (c & 7)))){
+            buf[5 + (i >> 3)] |= 1 << (i & 7);
+        }
+    }
+    return 0;
+}
+
+OTA_State ota_state(void){
+    return ota;
+}
+
+/*
+ * Checks a completely received delta and hands it to the bootloader. The delta is checked against
+ * its CRC, its base image against the running one, and then every segment is built into the scratch
+ * segment as a dry run to check the result before anything is overwritten. Returns 0 if the
+ * journal is written and the node should be reset, otherwise -1 with the reason in ota_state().
+ */
+int ota_commit(void){
+    DELTA_Stream s;
+    uint16_t crc = CRC16_INIT, i;
+    uint8_t seg, j[6];
+    if(ota != OTA_COMPLETE){
+        return -1;
+    }
+
+    for(i=0; i<ota_len; i++){
+        crc = crc16_update(crc, flash_read(OTA_STAGING_BASE + i));
+    }
+    if(crc != ota_crc){
+        ota = OTA_BAD_CRC;
+        return -1;
+    }
+    if(delta_open(&s, OTA_STAGING_BASE, ota_len) != 0 || s.old_crc != boot_image_crc()){
+        ota = OTA_BAD_BASE;
+        return -1;
+    }
+    crc = CRC16_INIT;
+    for(seg=0; seg<OTA_IMAGE_SEGS; seg++){
+        flash_erase(OTA_SCRATCH_BASE);
+        if(delta_segment(&s, seg, OTA_SCRATCH_BASE, &crc) != 0){
+            ota = OTA_BAD_IMAGE;
+            return -1;
+        }
+    }
+    if(crc != s.new_crc){
+        ota = OTA_BAD_IMAGE;
+        return -1;
+    }
+
+    flash_erase(OTA_JOURNAL_BASE);
+    j[0] = OTA_MAGIC & 0xFF;
+    j[1] = OTA_MAGIC >> 8;
+    j[2] = ota_len & 0xFF;
+    j[3] = ota_len >> 8;
+    j[4] = s.new_crc & 0xFF;
+    j[5] = s.new_crc >> 8;
+    flash_write(OTA_JOURNAL_BASE + OTA_J_LEN, &j[2], 4);
+    flash_write(OTA_JOURNAL_BASE + OTA_J_MAGIC, j, 2);  // Magic last, it marks the journal as valid
+    ota = OTA_IDLE;
+    return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Over the air firmware updates. The base station sends a compressed delta (see delta.h) against
+ * the running image in PKT_CMD_OTA_DATA chunks. The node writes them to a staging area in flash,
+ * tracks which chunks it has so a dropped link can be resumed, and on PKT_CMD_OTA_COMMIT checks the
+ * delta end to end before asking the bootloader (boot.c) to apply it.
+ *
+ * Flash layout
+ *  0x1000-0x103F   Info D, update journal
+ *  0xC000-0xE9FF   Application (21 segments), starts with the entry point (OTA_APP_ENTRY)
+ *  0xEA00-0xF7FF   Staging for a received delta (7 segments)
+ *  0xF800-0xF9FF   Scratch segment used while applying an update
+ *  0xFA00-0xFDFF   Bootloader: boot.c, flash.c, delta.c, and crc.c are linked here
+ *  0xFE00-0xFFFF   Interrupt vectors, the reset vector always points at the bootloader
+ *
+ * The image that updates are made against is the 21 application segments followed by the vector
+ * segment. lnk_msp430g2553_ota.cmd places the sections to match this layout.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+
+#ifndef OTA_H_
+#define OTA_H_
+
+#define OTA_APP_BASE        0xC000
+#define OTA_APP_SEGS        21
+#define OTA_VECT_BASE       0xFE00
+#define OTA_IMAGE_SEGS      (OTA_APP_SEGS + 1)
+#define OTA_IMAGE_SIZE      (OTA_IMAGE_SEGS * 512u)
+#define OTA_SEG_ADDR(i)     ((i) < OTA_APP_SEGS ? OTA_APP_BASE + (i)*512u : OTA_VECT_BASE)
+#define OTA_APP_ENTRY       OTA_APP_BASE            // Word holding the address of the C startup
+
+#define OTA_STAGING_BASE    0xEA00
+#define OTA_STAGING_SIZE    (7 * 512u)
+#define OTA_SCRATCH_BASE    0xF800
+#define OTA_BOOT_BASE       0xFA00
+#define OTA_BOOT_SIZE       (2 * 512u)
+#define OTA_JOURNAL_BASE    0x1000
+
+#define OTA_CHUNK           22                      // Delta bytes per PKT_CMD_OTA_DATA frame, fills a level 0 frame
+#define OTA_MAX_CHUNKS      ((OTA_STAGING_SIZE + OTA_CHUNK - 1) / OTA_CHUNK)
+#define OTA_STATUS_SIZE     13
+#define OTA_STATUS_WINDOW   64                      // Chunks covered by the bitmap in a status
+
+// Journal in info D. Bytes are only ever cleared so the journal survives a reset at any point.
+#define OTA_J_MAGIC         0                       // 2 bytes, OTA_MAGIC when an update is waiting
+#define OTA_J_LEN           2                       // 2 bytes, delta length
+#define OTA_J_CRC           4                       // 2 bytes, new image CRC
+#define OTA_J_BUILT         6                       // 1 byte per segment, 0 once scratch holds it
+#define OTA_J_DONE          (OTA_J_BUILT + OTA_IMAGE_SEGS)  // 1 byte per segment, 0 once copied back
+#define OTA_MAGIC           0xA55A
+
+typedef enum OTA_StateEnum{
+    OTA_IDLE,
+    OTA_RECEIVING,
+    OTA_COMPLETE,                           // Every chunk is in, waiting on commit
+    OTA_BAD_CRC,                            // Delta didn't match the CRC it was announced with
+    OTA_BAD_BASE,                           // Delta was made against a different image
+    OTA_BAD_IMAGE                           // Delta doesn't produce the image it says it does
+} OTA_State;
+
+int ota_begin(uint16_t len, uint16_t crc);
+int ota_chunk(uint16_t index, const uint8_t *data, uint8_t len);
+int ota_status(uint8_t *buf);
+OTA_State ota_state(void);
+int ota_commit(void);
+
+#endif /* OTA_H_ */
@@ -0,0 +1,185 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Building and parsing of the over the air frames. See packet.h for the layout.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+#include "packet.h"
+
+/*
+ * Builds a frame of any type from a body of len bytes
+ */
+int pkt_init(PKT_Frame *pkt, uint8_t node, uint8_t type, const uint8_t *body, uint8_t len){
+    if(PKT_HDR_SIZE + len > PKT_SIZE){
+        return -1;
+    }
+    pkt->buf[0] = node;
+    pkt->buf[1] = type;
+    pkt->buf[2] = len;
+    pkt->buf[3] = 0;
+    uint8_t i;
+    for(i=0; i<len; i++){
+        pkt->buf[PKT_HDR_SIZE + i] = body[i];
+    }
+    pkt->len = PKT_HDR_SIZE + len;
+    pkt->cap = PKT_SIZE;
+    return 0;
+}
+
+/*
+ * Points *body at the body of a received frame and returns its length, or -1 if malformed
+ */
+int pkt_body(const uint8_t *buf, uint8_t len, const uint8_t **body){
+    if(pkt_type(buf, len) < 0){
+        return -1;
+    }
+    *body = &buf[PKT_HDR_SIZE];
+    return buf[2];
+}
+
+/*
+ * Numbers a report, see seq.h
+ */
+void pkt_set_seq(PKT_Frame *pkt, uint8_t seq){
+    pkt->buf[3] = seq;
+}
+
+/*
+ * Starts an empty report from a node that can grow to cap bytes
+ */
+int pkt_report_init(PKT_Frame *pkt, uint8_t node, uint8_t cap){
+    if(cap < PKT_HDR_SIZE + 1 || cap > PKT_SIZE){
+        return -1;
+    }
+    pkt->cap = cap;
+    pkt->buf[0] = node;
+    pkt->buf[1] = PKT_REPORT;
+    pkt->buf[2] = 1;                        // Body is only the reading count so far
+    pkt->buf[3] = 0;
+    pkt->buf[PKT_HDR_SIZE] = 0;
+    pkt->len = PKT_HDR_SIZE + 1;
+    return 0;
+}
+
+/*
+ * Appends a reading to a report. Readings can't be added after the energy summary.
+ */
+int pkt_report_add(PKT_Frame *pkt, uint8_t sensor, int16_t value){
+    if((pkt->buf[1] & PKT_F_ENERGY) || (pkt->len + PKT_READING_SIZE > pkt->cap)){
+        return -1;                          // Error if the summary is already on or the frame is full
+    }
+    pkt->buf[pkt->len] = sensor;
+    pkt->buf[pkt->len+1] = (uint16_t)value & 0xFF;
+    pkt->buf[pkt->len+2] = ((uint16_t)value >> 8) & 0xFF;
+    pkt->len += PKT_READING_SIZE;
+    pkt->buf[2] += PKT_READING_SIZE;
+    pkt->buf[PKT_HDR_SIZE]++;
+    return 0;
+}
+
+/*
+ * Piggybacks an energy summary from power_summary() on the end of a report
+ */
+int pkt_report_energy(PKT_Frame *pkt, const uint8_t *summary){
+    if((pkt->buf[1] & PKT_F_ENERGY) || (pkt->len + PKT_ENERGY_SIZE > pkt->cap)){
+        return -1;
+    }
+    uint8_t i;
+    for(i=0; i<PKT_ENERGY_SIZE; i++){
+        pkt->buf[pkt->len+i] = summary[i];
+    }
+    pkt->len += PKT_ENERGY_SIZE;
+    pkt->buf[2] += PKT_ENERGY_SIZE;
+    pkt->buf[1] |= PKT_F_ENERGY;
+    return 0;
+}
+
+/*
+ * Reads a control frame received by a node. Returns the number of argument bytes at *args, or -1 if
+ * the frame isn't a well formed control frame.
+ */
+int pkt_control_parse(const uint8_t *buf, uint8_t len, uint8_t *cmd, const uint8_t **args){
+    if(pkt_type(buf, len) != PKT_CONTROL || buf[2] < 1){
+        return -1;
+    }
+    *cmd = buf[PKT_HDR_SIZE];
+    *args = &buf[PKT_HDR_SIZE + 1];
+    return buf[2] - 1;
+}
+
+/*
+ * Returns the type of a received frame or -1 if the header is malformed
+ */
+int pkt_type(const uint8_t *buf, uint8_t len){
+    if(len < PKT_HDR_SIZE || PKT_HDR_SIZE + buf[2] > len){
+        return -1;
+    }
+    return buf[1] & 0x0F;
+}
+
+/*
+ * Decodes a received report. Returns -1 if the frame isn't a well formed report.
+ */
+int pkt_report_parse(const uint8_t *buf, uint8_t len, PKT_Report *report){
+    if(pkt_type(buf, len) != PKT_REPORT || buf[2] < 1){
+        return -1;
+    }
+    uint8_t body = buf[2];
+    uint8_t count = buf[PKT_HDR_SIZE];
+    uint8_t need = 1 + count*PKT_READING_SIZE + ((buf[1] & PKT_F_ENERGY) ? PKT_ENERGY_SIZE : 0);
+    if(need != body || count > sizeof(report->readings)/sizeof(report->readings[0])){
+        return -1;
+    }
+
+    report->node = buf[0];
+    report->flags = buf[1] & 0xF0;
+    report->seq = buf[3];
+    report->count = count;
+    const uint8_t *p = &buf[PKT_HDR_SIZE + 1];
+    uint8_t i;
+    for(i=0; i<count; i++){
+        report->readings[i].sensor = p[0];
+        report->readings[i].value = (int16_t)(p[1] | (p[2] << 8));
+        p += PKT_READING_SIZE;
+    }
+    if(report->flags & PKT_F_ENERGY){
+        report->charge_uah = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+        report->top_state = p[4];
+        report->top_share = p[5];
+    }
+    else{
+        report->charge_uah = 0;
+        report->top_state = 0;
+        report->top_share = 0;
+    }
+    return 0;
+}
+
+/*
+ * Builds a control frame for a node with nargs argument bytes
+ */
+int pkt_control_init(PKT_Frame *pkt, uint8_t node, uint8_t cmd, const uint8_t *args, uint8_t nargs){
+    if(PKT_HDR_SIZE + 1 + nargs > PKT_SIZE){
+        return -1;
+    }
+    pkt->buf[0] = node;
+    pkt->buf[1] = PKT_CONTROL;
+    pkt->buf[2] = 1 + nargs;
+    pkt->buf[3] = 0;
+    pkt->buf[PKT_HDR_SIZE] = cmd;
+    uint8_t i;
+    for(i=0; i<nargs; i++){
+        pkt->buf[PKT_HDR_SIZE + 1 + i] = args[i];
+    }
+    pkt->len = PKT_HDR_SIZE + 1 + nargs;
+    pkt->cap = PKT_SIZE;
+    return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * The over the air frame format shared by the nodes and the base station. Frames are packed byte by
+ * byte (multi-byte fields are little endian) so the layout is the same on the MSP430 and on a PC.
+ * No MSP430 specific headers are used here so the base station can build it as is.
+ *
+ * Frame layout (PKT_SIZE bytes max, the nRF24 payload size)
+ *  [0]     Node ID
+ *  [1]     Type (low nibble) and flags (high nibble)
+ *  [2]     Body length
+ *  [3]     Sequence number of a report, counted per node (seq.h). 0 in other frames.
+ *  [4..]   Body
+ *
+ * Report body
+ *  [0]     Number of readings, n
+ *  [1..]   n readings of sensor ID (1 byte) and value (int16)
+ *  [...]   Energy summary (PWR_SUMMARY_SIZE bytes) if PKT_F_ENERGY is set
+ *
+ * Control body, sent from the base station to a node
+ *  [0]     Command
+ *  [1..]   Arguments
+ *
+ * OTA status body, sent by a node during a firmware update
+ *  [0..]   OTA_STATUS_SIZE bytes from ota_status()
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+
+#ifndef PACKET_H_
+#define PACKET_H_
+
+#define PKT_SIZE            32          // nRF24 max payload
+#define PKT_HDR_SIZE        4
+#define PKT_READING_SIZE    3
+#define PKT_ENERGY_SIZE     6           // Must match PWR_SUMMARY_SIZE
+
+// Frame types
+#define PKT_REPORT          0x01
+#define PKT_CONTROL         0x02
+#define PKT_OTA_STATUS      0x03
+
+// Control commands
+#define PKT_CMD_FEC         0x01        // [level] FEC level to send at from now on
+#define PKT_CMD_OTA_BEGIN   0x02        // [length u16][CRC u16] Start or resume receiving a delta
+#define PKT_CMD_OTA_DATA    0x03        // [chunk u16][up to OTA_CHUNK bytes]
+#define PKT_CMD_OTA_QUERY   0x04        // Node answers with a PKT_OTA_STATUS
+#define PKT_CMD_OTA_COMMIT  0x05        // Check the delta and reset into the bootloader
+#define PKT_CMD_SAMPLING    0x06        // [sensor][min u16][max u16][rate limit u16][setpoint i16][band u16]
+#define PKT_CMD_RESEND      0x07        // [first seq][mask] Resend report first + i for every bit i set in mask
+
+#define PKT_RECENT          4           // Reports a node keeps to resend, the base station asks for no older
+
+// Frame flags
+#define PKT_F_ENERGY        0x10        // Energy summary follows the readings
+#define PKT_F_RESENT        0x20        // Report sent again in answer to a PKT_CMD_RESEND
+#define PKT_F_BOOT          0x40        // First report since the node started, its sequence starts over
+
+// Sensor IDs
+#define PKT_SEN_TEMP        0x01        // Degrees C
+#define PKT_SEN_DEPTH       0x02        // Snow depth in mm
+
+// Sampling readings, or'd with a sensor ID, value in seconds
+#define PKT_SEN_PERIOD      0x40        // Current sampling period
+#define PKT_SEN_MIN         0x80        // Minimum period
+#define PKT_SEN_MAX         0xC0        // Maximum period
+#define PKT_SEN_MASK        0x3F
+
+typedef struct PKT_FrameStruct{
+    uint8_t buf[PKT_SIZE];
+    uint8_t len;                        // Total bytes used in buf
+    uint8_t cap;                        // Bytes the frame may grow to, ex: fec_capacity()
+} PKT_Frame;
+
+typedef struct PKT_ReadingStruct{
+    uint8_t sensor;
+    int16_t value;
+} PKT_Reading;
+
+// Decoded report for the base station
+typedef struct PKT_ReportStruct{
+    uint8_t node;
+    uint8_t flags;
+    uint8_t seq;
+    uint8_t count;
+    PKT_Reading readings[(PKT_SIZE - PKT_HDR_SIZE - 1) / PKT_READING_SIZE];
+    uint32_t charge_uah;                // Only valid if PKT_F_ENERGY is set
+    uint8_t top_state;
+    uint8_t top_share;
+} PKT_Report;
+
+int pkt_init(PKT_Frame *pkt, uint8_t node, uint8_t type, const uint8_t *body, uint8_t len);
+int pkt_body(const uint8_t *buf, uint8_t len, const uint8_t **body);
+void pkt_set_seq(PKT_Frame *pkt, uint8_t seq);
+
+// Used on the nodes
+int pkt_report_init(PKT_Frame *pkt, uint8_t node, uint8_t cap);
+int pkt_report_add(PKT_Frame *pkt, uint8_t sensor, int16_t value);
+int pkt_report_energy(PKT_Frame *pkt, const uint8_t *summary);
+int pkt_control_parse(const uint8_t *buf, uint8_t len, uint8_t *cmd, const uint8_t **args);
+
+// Used on the base station
+int pkt_type(const uint8_t *buf, uint8_t len);
+int pkt_report_parse(const uint8_t *buf, uint8_t len, PKT_Report *report);
+int pkt_control_init(PKT_Frame *pkt, uint8_t node, uint8_t cmd, const uint8_t *args, uint8_t nargs);
+
+#endif /* PACKET_H_ */
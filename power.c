@@ -0,0 +1,261 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Energy accounting for the MSP430G2553. Timer0_A free runs off of ACLK and the time spent in each
+ * power state is accumulated so that the charge drawn by a node can be estimated and reported.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <msp430g2553.h>
+#include <stdint.h>
+#include "power.h"
+
+// Approximate supply current in uA for each state at 3V (G2553 and nRF24L01+ datasheets)
+const uint16_t pwr_ua[PWR_NUM_STATES] = {
+    230,        // Active at 1 MHz
+    1800,       // Active at 8 MHz
+    2700,       // Active at 12 MHz
+    3600,       // Active at 16 MHz
+    90,         // LPM0 (DCO left running)
+    1,          // LPM3 with the 32k XTAL
+    850,        // ADC10 core and 2.5V reference
+    11300,      // Radio TX at 0 dBm
+    13500,      // Radio RX
+    26,         // Radio standby-I
+    1,          // Radio power down (0.9 uA)
+    2,          // Regulator quiescent current (MCP1700, 1.6 uA)
+    2000,       // Ranger idle (HC-SR04 class, < 2 mA quiescent)
+    15000       // Ranger sending a burst and listening for the echo
+};
+
+// Global Variables
+volatile uint32_t pwr_ticks[PWR_NUM_STATES] = {0};     // Cumulative ACLK ticks spent in each state
+volatile PWR_State pwr_state[PWR_NUM_DOMAINS] = {PWR_ACTIVE_1MHZ, PWR_OFF, PWR_RADIO_PD, PWR_BOARD_FLOOR,
+                                                  PWR_RANGER_IDLE};
+volatile uint16_t pwr_stamp[PWR_NUM_DOMAINS] = {0};    // TA0R at the last state change of each domain
+PWR_State pwr_active = PWR_ACTIVE_1MHZ;                 // CPU state to return to when leaving a LPM
+uint32_t pwr_reported[PWR_NUM_STATES] = {0};            // pwr_ticks at the last summary
+uint64_t pwr_charge_acc = 0;                            // Unreported charge in uA*ticks
+uint32_t pwr_charge_uah = 0;                            // Reported charge since boot in uAh
+
+/*
+ * Reads TA0R. ACLK is asynchronous to MCLK so the count is read until two reads agree
+ */
+static uint16_t power_now(void){
+    uint16_t a, b;
+    do{
+        a = TA0R;
+        b = TA0R;
+    } while(a != b);
+    return a;
+}
+
+/*
+ * Charges every domain for the time since its last stamp. Must be called with interrupts disabled.
+ * The unsigned 16 bit subtraction handles a single wrap of TA0R, and the overflow interrupt calls
+ * this at least once per wrap, so no span is ever lost.
+ */
+static void power_flush(void){
+    uint16_t now = power_now();
+    uint8_t i;
+    for(i=0; i<PWR_NUM_DOMAINS; i++){
+        if(pwr_state[i] != PWR_OFF){
+            pwr_ticks[pwr_state[i]] += (uint16_t)(now - pwr_stamp[i]);
+        }
+        pwr_stamp[i] = now;
+    }
+}
+
+/*
+ * Starts Timer0_A in continuous mode off of ACLK with the overflow interrupt enabled
+ * Timer0_A is owned by this library; CCR0 is used by power_sleep()
+ */
+int power_init(void){
+    uint8_t i;
+    TA0CTL = TASSEL_1 + MC_2 + TACLR + TAIE;  // ACLK, continuous mode, clear count, overflow interrupt
+    TA0CCTL0 = 0x00;
+    for(i=0; i<PWR_NUM_DOMAINS; i++){
+        pwr_stamp[i] = 0;
+    }
+    return 0;
+}
+
+/*
+ * Switches MCLK and SMCLK to one of the calibrated DCO frequencies (1, 8, 12, or 16 MHz) and
+ * charges active time against the matching state from here on
+ */
+int power_set_dco(uint8_t mhz){
+    switch(mhz){
+        case 1:
+            DCOCTL = 0x00;
+            BCSCTL1 = CALBC1_1MHZ;
+            DCOCTL = CALDCO_1MHZ;
+            pwr_active = PWR_ACTIVE_1MHZ;
+            break;
+        case 8:
+            DCOCTL = 0x00;
+            BCSCTL1 = CALBC1_8MHZ;
+            DCOCTL = CALDCO_8MHZ;
+            pwr_active = PWR_ACTIVE_8MHZ;
+            break;
+        case 12:
+            DCOCTL = 0x00;
+            BCSCTL1 = CALBC1_12MHZ;
+            DCOCTL = CALDCO_12MHZ;
+            pwr_active = PWR_ACTIVE_12MHZ;
+            break;
+        case 16:
+            DCOCTL = 0x00;
+            BCSCTL1 = CALBC1_16MHZ;
+            DCOCTL = CALDCO_16MHZ;
+            pwr_active = PWR_ACTIVE_16MHZ;
+            break;
+        default:
+            return -1;
+    }
+    power_mark(PWR_CPU, pwr_active);
+    return 0;
+}
+
+/*
+ * Moves a domain to a new state, charging the old state for the time spent in it
+ */
+void power_mark(PWR_Domain domain, PWR_State state){
+    __istate_t gie = __get_interrupt_state();
+    __disable_interrupt();
+    power_flush();
+    pwr_state[domain] = state;
+    __set_interrupt_state(gie);
+}
+
+/*
+ * Call directly before entering LPM0 or LPM3 and power_lpm_exit() directly after waking
+ */
+void power_lpm_enter(PWR_State lpm){
+    power_mark(PWR_CPU, lpm);
+}
+
+void power_lpm_exit(void){
+    power_mark(PWR_CPU, pwr_active);
+}
+
+/*
+ * Sleeps in LPM3 for a number of ACLK ticks using CCR0 as the wakeup. Sleeps longer than half a
+ * timer wrap are split up. Interrupts are enabled while asleep and restored to their previous state
+ * on return.
+ */
+void power_sleep(uint32_t ticks){
+    uint16_t chunk;
+    __istate_t gie = __get_interrupt_state();
+    while(ticks > 0){
+        chunk = (ticks > 0x8000) ? 0x8000 : ticks;
+        ticks -= chunk;
+        __disable_interrupt();
+        TA0CCR0 = power_now() + chunk;
+        TA0CCTL0 = CCIE;                    // Compare interrupt wakes the CPU
+        power_flush();
+        pwr_state[PWR_CPU] = PWR_LPM3;
+        __bis_SR_register(LPM3_bits + GIE); // Sleep until the compare interrupt
+        power_lpm_exit();
+    }
+    __set_interrupt_state(gie);
+}
+
+/*
+ * Returns the cumulative ACLK ticks spent in a state, including the span currently in progress
+ */
+uint32_t power_ticks(PWR_State state){
+    uint32_t ticks;
+    __istate_t gie = __get_interrupt_state();
+    __disable_interrupt();
+    power_flush();
+    ticks = pwr_ticks[state];
+    __set_interrupt_state(gie);
+    return ticks;
+}
+
+/*
+ * Writes a compact energy summary of PWR_SUMMARY_SIZE bytes to buf for piggybacking on a report
+ *
+ * buf[0..3] estimated charge drawn since boot in uAh, little endian
+ * buf[4] state that drew the most charge since the last summary
+ * buf[5] percentage of the charge since the last summary drawn by that state
+ */
+int power_summary(uint8_t *buf){
+    uint32_t delta[PWR_NUM_STATES];
+    uint64_t charge, total = 0, top_charge = 0;
+    uint8_t i, top = PWR_LPM3, share = 0;
+
+    __istate_t gie = __get_interrupt_state();
+    __disable_interrupt();
+    power_flush();
+    for(i=0; i<PWR_NUM_STATES; i++){
+        delta[i] = pwr_ticks[i] - pwr_reported[i];
+        pwr_reported[i] = pwr_ticks[i];
+    }
+    __set_interrupt_state(gie);
+
+    for(i=0; i<PWR_NUM_STATES; i++){        // No hardware multiplier, but this only runs once per report
+        charge = (uint64_t)delta[i] * pwr_ua[i];
+        total += charge;
+        if(charge > top_charge){
+            top_charge = charge;
+            top = i;
+        }
+    }
+    if(total > 0){
+        share = (uint8_t)((top_charge * 100) / total);
+    }
+
+    pwr_charge_acc += total;                // Carry the remainder so slow nodes still count up
+    pwr_charge_uah += (uint32_t)(pwr_charge_acc / ((uint64_t)PWR_ACLK_HZ * 3600));
+    pwr_charge_acc %= (uint64_t)PWR_ACLK_HZ * 3600;
+
+    buf[0] = pwr_charge_uah & 0xFF;
+    buf[1] = (pwr_charge_uah >> 8) & 0xFF;
+    buf[2] = (pwr_charge_uah >> 16) & 0xFF;
+    buf[3] = (pwr_charge_uah >> 24) & 0xFF;
+    buf[4] = top;
+    buf[5] = share;
+    return 0;
+}
+
+/*
+ * Interrupts
+ */
+// CCR0 interrupt vector, used to wake from power_sleep()
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector=TIMER0_A0_VECTOR
+__interrupt void TIMER0_A0_ISR(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) TIMER0_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    TA0CCTL0 &= ~CCIE;                      // One shot
+    LPM3_EXIT;                              // Exit LPM3
+}
+
+// Overflow interrupt vector, charges every domain once per wrap of TA0R
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector=TIMER0_A1_VECTOR
+__interrupt void TIMER0_A1_ISR(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_A1_VECTOR))) TIMER0_A1_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    switch(TA0IV){
+    case TA0IV_TAIFG:                       // Stay in the current LPM, only the counters are updated
+        power_flush();
+        break;
+    }
+}
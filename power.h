@@ -0,0 +1,67 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Energy accounting for the MSP430G2553. Timer0_A free runs off of ACLK and the time spent in each
+ * power state is accumulated so that the charge drawn by a node can be estimated and reported. The
+ * CPU, the ADC reference, and the radio are tracked as separate domains since they overlap in time
+ * (ex: radio in RX while the CPU sits in LPM0). Loads that never turn off, like the regulator, are
+ * charged to the board domain the whole time, and the radio draws its power-down current when off.
+ * The ultrasonic ranger has no supply switch, so it draws its idle current between pings.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#define PWR_ACLK_HZ         32768       // ACLK rate used for accounting. Wrong by ~3x while ACLK is still on the VLO
+#define PWR_DCO_MHZ         16          // What main.c passes to power_set_dco(), timing off of MCLK/SMCLK assumes it
+#define PWR_SUMMARY_SIZE    6           // Bytes written by power_summary()
+
+// States that time is accounted against
+typedef enum PWR_StateEnum{
+    PWR_ACTIVE_1MHZ,
+    PWR_ACTIVE_8MHZ,
+    PWR_ACTIVE_12MHZ,
+    PWR_ACTIVE_16MHZ,
+    PWR_LPM0,
+    PWR_LPM3,
+    PWR_ADC_REF,
+    PWR_RADIO_TX,
+    PWR_RADIO_RX,
+    PWR_RADIO_STBY,
+    PWR_RADIO_PD,
+    PWR_BOARD_FLOOR,
+    PWR_RANGER_IDLE,
+    PWR_RANGER_PING,
+    PWR_NUM_STATES,
+    PWR_OFF = PWR_NUM_STATES            // Domain is powered down and is not charged
+} PWR_State;
+
+// Independent domains, each of which is always in exactly one state
+typedef enum PWR_DomainEnum{
+    PWR_CPU,
+    PWR_ADC,
+    PWR_RADIO,
+    PWR_BOARD,                          // Always on, never leaves PWR_BOARD_FLOOR
+    PWR_RANGER,                         // Powered all the time, idle between pings
+    PWR_NUM_DOMAINS
+} PWR_Domain;
+
+int power_init(void);
+int power_set_dco(uint8_t mhz);
+void power_mark(PWR_Domain domain, PWR_State state);
+void power_lpm_enter(PWR_State lpm);
+void power_lpm_exit(void);
+void power_sleep(uint32_t ticks);
+uint32_t power_ticks(PWR_State state);
+int power_summary(uint8_t *buf);
+
+#endif /* POWER_H_ */
@@ -0,0 +1,174 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * A minimal driver for the nRF24L01+ on USCI-B0. CSN is on P1.5 and CE is on P2.3. Every change of
+ * radio mode is reported to the energy accounting in power.h.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <msp430g2553.h>
+#include <stdint.h>
+#include "usci.h"
+#include "power.h"
+#include "radio.h"
+
+// nRF24 commands and registers
+#define NRF_R_REGISTER      0x00
+#define NRF_W_REGISTER      0x20
+#define NRF_R_RX_PAYLOAD    0x61
+#define NRF_W_TX_PAYLOAD    0xA0
+#define NRF_CONFIG          0x00
+#define NRF_EN_AA           0x01
+#define NRF_SETUP_RETR      0x04
+#define NRF_STATUS          0x07
+#define NRF_RX_PW_P0        0x11
+
+// CONFIG and STATUS bits
+#define NRF_PRIM_RX         0x01
+#define NRF_PWR_UP          0x02
+#define NRF_EN_CRC          0x08
+#define NRF_MAX_RT          0x10
+#define NRF_TX_DS           0x20
+#define NRF_RX_DR           0x40
+#define NRF_RX_P_NO         0x0E        // Pipe of the payload at the head of the RX FIFO, all ones if empty
+
+#if RADIO_FEC
+#define NRF_CRC             0x00        // CRC is done in software, see fec.h
+#else
+#define NRF_CRC             NRF_EN_CRC
+#endif
+
+// Timing off of MCLK, see PWR_DCO_MHZ
+#define RADIO_STARTUP_CYCLES    (PWR_DCO_MHZ * 1500UL)  // 1.5 ms crystal startup
+#define RADIO_CE_CYCLES         (PWR_DCO_MHZ * 15)      // CE must be held high for at least 10 us
+#define RADIO_POLL_CYCLES       (PWR_DCO_MHZ * 100)     // 100 us between STATUS polls
+#define RADIO_SEND_POLLS        100                     // 10 ms, well past 3 retransmits of a payload
+
+#define CSN_LOW     P1OUT &= ~BIT5
+#define CSN_HIGH    do{ while(UCB0STAT & UCBUSY); P1OUT |= BIT5; } while(0)  // Let the last byte shift out first
+#define CE_LOW      P2OUT &= ~BIT3
+#define CE_HIGH     P2OUT |= BIT3
+
+/*
+ * Writes a single register
+ */
+static int radio_write_reg(char reg, char value){
+    int err;
+    CSN_LOW;
+    err = B0_spi_transmit(NRF_W_REGISTER | reg, &value, 1);
+    CSN_HIGH;
+    return err;
+}
+
+/*
+ * Reads a single register
+ */
+static char radio_read_reg(char reg){
+    char value = 0;
+    CSN_LOW;
+    B0_spi_receive(NRF_R_REGISTER | reg, &value, 1);
+    CSN_HIGH;
+    return value;
+}
+
+/*
+ * Powers up the radio into standby-I. USCI-B0 must already be initialized.
+ */
+int radio_init(void){
+    P2DIR |= BIT3;
+    CE_LOW;
+#if RADIO_FEC
+    radio_write_reg(NRF_EN_AA, 0x00);                                   // No auto-ack or retransmits
+    radio_write_reg(NRF_SETUP_RETR, 0x00);
+    radio_write_reg(NRF_RX_PW_P0, RADIO_PAYLOAD_SIZE);                  // Fixed width frames
+#endif
+    radio_write_reg(NRF_STATUS, NRF_RX_DR + NRF_TX_DS + NRF_MAX_RT);   // Clear stale flags
+    radio_write_reg(NRF_CONFIG, NRF_CRC + NRF_PWR_UP);
+    __delay_cycles(RADIO_STARTUP_CYCLES);
+    power_mark(PWR_RADIO, PWR_RADIO_STBY);
+    return 0;
+}
+
+/*
+ * Transmits one payload and waits for it to be acknowledged. Returns -1 if the radio gave up after
+ * its auto-retransmits, or never said it was done. With RADIO_FEC this returns as soon as the
+ * payload is on the air.
+ */
+int radio_send(char *data, char length){
+    char status;
+    uint8_t polls = 0;
+    if(length > RADIO_PAYLOAD_SIZE){
+        return -1;
+    }
+    radio_write_reg(NRF_CONFIG, NRF_CRC + NRF_PWR_UP);             // PTX
+    CSN_LOW;
+    B0_spi_transmit(NRF_W_TX_PAYLOAD, data, length);
+    CSN_HIGH;
+
+    CE_HIGH;
+    power_mark(PWR_RADIO, PWR_RADIO_TX);
+    __delay_cycles(RADIO_CE_CYCLES);
+    CE_LOW;
+    do{
+        __delay_cycles(RADIO_POLL_CYCLES);  // An ACK'd payload takes ~250 us
+        status = radio_read_reg(NRF_STATUS);
+    } while(!(status & (NRF_TX_DS + NRF_MAX_RT)) && ++polls < RADIO_SEND_POLLS);
+    radio_write_reg(NRF_STATUS, NRF_TX_DS + NRF_MAX_RT);
+    power_mark(PWR_RADIO, PWR_RADIO_STBY);
+
+    if(!(status & NRF_TX_DS)){
+        return -1;                          // Gave up, or no answer from the radio
+    }
+    return 0;
+}
+
+/*
+ * Switches to PRX and starts listening
+ */
+int radio_listen(void){
+    radio_write_reg(NRF_CONFIG, NRF_CRC + NRF_PWR_UP + NRF_PRIM_RX);
+    CE_HIGH;
+    power_mark(PWR_RADIO, PWR_RADIO_RX);
+    return 0;
+}
+
+/*
+ * Reads a received payload into data (RADIO_PAYLOAD_SIZE bytes). Returns -1 if nothing has arrived.
+ * Checks the FIFO rather than RX_DR, which isn't set again for payloads already queued behind the
+ * first, so calling this until it fails empties the FIFO.
+ */
+int radio_read(char *data){
+    if((radio_read_reg(NRF_STATUS) & NRF_RX_P_NO) == NRF_RX_P_NO){
+        return -1;
+    }
+    CSN_LOW;
+    B0_spi_receive(NRF_R_RX_PAYLOAD, data, RADIO_PAYLOAD_SIZE);
+    CSN_HIGH;
+    radio_write_reg(NRF_STATUS, NRF_RX_DR);
+    return 0;
+}
+
+/*
+ * Drops back to standby-I from RX
+ */
+int radio_standby(void){
+    CE_LOW;
+    power_mark(PWR_RADIO, PWR_RADIO_STBY);
+    return 0;
+}
+
+/*
+ * Powers the radio down completely between reports
+ */
+int radio_power_down(void){
+    CE_LOW;
+    radio_write_reg(NRF_CONFIG, NRF_CRC);
+    power_mark(PWR_RADIO, PWR_RADIO_PD);
+    return 0;
+}
@@ -0,0 +1,33 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * A minimal driver for the nRF24L01+ on USCI-B0. CSN is on P1.5 and CE is on P2.3. Every change of
+ * radio mode is reported to the energy accounting in power.h.
+ *
+ * With RADIO_FEC set, Enhanced ShockBurst (hardware CRC, auto-ack, and auto-retransmit) is turned
+ * off and every payload is a full 32 byte frame from fec.h. Corrupted frames then reach the
+ * receiver and can be repaired instead of being dropped and sent again. The setting must match
+ * across the whole network.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#ifndef RADIO_H_
+#define RADIO_H_
+
+#define RADIO_PAYLOAD_SIZE  32
+#define RADIO_FEC           1           // Software FEC in place of Enhanced ShockBurst
+
+int radio_init(void);
+int radio_send(char *data, char length);
+int radio_listen(void);
+int radio_read(char *data);
+int radio_standby(void);
+int radio_power_down(void);
+
+#endif /* RADIO_H_ */
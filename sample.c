@@ -0,0 +1,99 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Adaptive sampling periods, see sample.h
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+#include "sample.h"
+
+/*
+ * Sets up a sensor to sample straight away and then at its minimum period until it settles
+ */
+int smp_init(SMP_Sensor *s, uint16_t min_period, uint16_t max_period, uint16_t rate_limit, int16_t setpoint, uint16_t band){
+    if(min_period == 0 || max_period < min_period){
+        return -1;
+    }
+    s->min_period = min_period;
+    s->max_period = max_period;
+    s->rate_limit = rate_limit;
+    s->setpoint = setpoint;
+    s->band = band;
+    s->period = min_period;
+    s->wait = 0;
+    s->have_last = 0;
+    return 0;
+}
+
+/*
+ * Takes a new reading and picks the period until the next one. Returns the new period.
+ */
+uint16_t smp_update(SMP_Sensor *s, int16_t value){
+    uint8_t fast = 0;
+    int32_t diff;
+
+    if(s->have_last){
+        diff = (int32_t)value - s->last;
+        if(diff < 0){
+            diff = -diff;
+        }
+        if((uint32_t)diff * 3600 >= (uint32_t)s->rate_limit * s->period){   // Per hour, without dividing
+            fast = 1;
+        }
+    }
+    if(s->band != SMP_NO_BAND){
+        diff = (int32_t)value - s->setpoint;
+        if(diff >= -(int32_t)s->band && diff <= s->band){
+            fast = 1;
+        }
+    }
+
+    if(fast){
+        s->period = s->min_period;
+    }
+    else if(s->period > s->max_period / 2){
+        s->period = s->max_period;
+    }
+    else{
+        s->period *= 2;                     // Back off exponentially while it is calm
+    }
+    s->last = value;
+    s->have_last = 1;
+    s->wait = s->period;
+    return s->period;
+}
+
+/*
+ * Seconds until the next sensor is due
+ */
+uint16_t smp_next(const SMP_Sensor *sensors, uint8_t n){
+    uint16_t next = 0xFFFF;
+    uint8_t i;
+    for(i=0; i<n; i++){
+        if(sensors[i].wait < next){
+            next = sensors[i].wait;
+        }
+    }
+    return next;
+}
+
+/*
+ * Counts time off every sensor. Returns a bit mask of the sensors that are now due.
+ */
+uint8_t smp_elapse(SMP_Sensor *sensors, uint8_t n, uint16_t seconds){
+    uint8_t i, due = 0;
+    for(i=0; i<n; i++){
+        sensors[i].wait = (sensors[i].wait > seconds) ? sensors[i].wait - seconds : 0;
+        if(sensors[i].wait == 0){
+            due |= 1 << i;
+        }
+    }
+    return due;
+}
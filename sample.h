@@ -0,0 +1,41 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Adaptive sampling periods. Each sensor samples at its minimum period while its reading is
+ * changing faster than a limit, or is within a band of a setpoint (ex: 0 C for freeze-thaw), and
+ * otherwise doubles its period each sample up to its maximum. All integer math with no hardware
+ * access so the policy runs the same on a PC against recorded traces (base/sampletrace).
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+
+#ifndef SAMPLE_H_
+#define SAMPLE_H_
+
+#define SMP_NO_BAND     0               // Band value that turns off the setpoint check
+
+typedef struct SMP_SensorStruct{
+    uint16_t min_period;                // Seconds
+    uint16_t max_period;                // Seconds
+    uint16_t rate_limit;                // Change per hour at or above which sampling speeds up
+    int16_t setpoint;
+    uint16_t band;                      // Sampling speeds up within +/- band of the setpoint
+    uint16_t period;                    // Current period in seconds
+    uint16_t wait;                      // Seconds until the next sample
+    int16_t last;
+    uint8_t have_last;
+} SMP_Sensor;
+
+int smp_init(SMP_Sensor *s, uint16_t min_period, uint16_t max_period, uint16_t rate_limit, int16_t setpoint, uint16_t band);
+uint16_t smp_update(SMP_Sensor *s, int16_t value);
+uint16_t smp_next(const SMP_Sensor *sensors, uint8_t n);
+uint8_t smp_elapse(SMP_Sensor *sensors, uint8_t n, uint16_t seconds);
+
+#endif /* SAMPLE_H_ */
@@ -5,26 +5,158 @@
  *      Author: ejjonesiii
  */
 
+#include <msp430g2553.h>
+#include <stdint.h>
 #include "adc.h"
+#include "power.h"
+#include "sensors.h"
 
-int distance(void){
-    int raw;
-    adc_single_init(ADC0);
-    raw = adc_single_read();
+// Echo capture state, written by the Timer1_A ISRs
+#define ECHO_WAIT_RISE  0
+#define ECHO_WAIT_FALL  1
+#define ECHO_DONE       2
+#define ECHO_TIMED_OUT  3
+
+volatile uint8_t echo_state = ECHO_DONE;
+volatile uint16_t echo_rise = 0;
+volatile uint16_t echo_fall = 0;
+
+/*
+ * Sets up the trigger output and hands the echo pin to Timer1_A
+ */
+int snow_depth_init(void){
+    P2DIR |= BIT0;                          // Trigger
+    P2OUT &= ~BIT0;
+    P2DIR &= ~BIT1;                         // Echo into TA1.1 (CCI1A)
+    P2SEL |= BIT1;
+    P2SEL2 &= ~BIT1;
+    return 0;
+}
 
+/*
+ * Sends one ping and times the echo with Timer1_A capturing both edges. The CPU sleeps in LPM0
+ * (SMCLK has to keep running for the timer) until the falling edge or the timeout.
+ * Returns the echo width in timer ticks or -1 if there was no echo.
+ */
+static int32_t ping(void){
+    echo_state = ECHO_WAIT_RISE;
+    TA1CTL = TASSEL_2 + ID_3 + MC_2 + TACLR;    // SMCLK/8, continuous mode
+    TA1CCTL1 = CM_3 + CCIS_0 + SCS + CAP + CCIE;    // Capture both edges of CCI1A, synchronized
+    TA1CCR0 = ECHO_TIMEOUT;
+    TA1CCTL0 = CCIE;                        // Timeout
+
+    power_mark(PWR_RANGER, PWR_RANGER_PING);
+    P2OUT |= BIT0;                          // 10 us trigger pulse
+    __delay_cycles(TRIGGER_CYCLES);
+    P2OUT &= ~BIT0;
+
+    power_lpm_enter(PWR_LPM0);
+    __bis_SR_register(LPM0_bits + GIE);     // Sleep until the echo is timed
+    power_lpm_exit();
+    __disable_interrupt();
+    power_mark(PWR_RANGER, PWR_RANGER_IDLE);
+
+    TA1CTL = MC_0;                          // Stop the timer between pings
+    TA1CCTL0 = 0;
+    TA1CCTL1 = 0;
+    if(echo_state != ECHO_DONE){
+        return -1;
+    }
+    return (uint16_t)(echo_fall - echo_rise);
 }
 
+/*
+ * Snow depth in mm from DEPTH_PINGS pings, or -1 if too few pings got an echo. The median ping is
+ * used so a single echo off a falling snowflake or branch is thrown out. The speed of sound is
+ * corrected for air temperature using the on-chip sensor.
+ */
+int snow_depth(void){
+    int32_t pings[DEPTH_PINGS], t;
+    uint8_t n = 0, i, j;
+    int temp = temperature();
+
+    for(i=0; i<DEPTH_PINGS; i++){
+        t = ping();
+        if(t >= 0){
+            for(j=n; j>0 && pings[j-1] > t; j--){  // Insertion sort as they come in
+                pings[j] = pings[j-1];
+            }
+            pings[j] = t;
+            n++;
+        }
+        if(i < DEPTH_PINGS-1){
+            power_sleep(DEPTH_GAP_TICKS);
+        }
+    }
+    if(n < DEPTH_PINGS/2 + 1){
+        return -1;                          // Median wouldn't be of a majority
+    }
+
+    // c = 331.3 + 0.606*T m/s, in 0.1 m/s. Distance is half the round trip.
+    uint32_t c = 3313 + (606L*temp)/100;
+    uint32_t distance = ((uint32_t)pings[n/2] * c) / (2UL * ECHO_TICK_HZ / 100);
+    if(distance >= DEPTH_MOUNT_MM){
+        return 0;
+    }
+    return DEPTH_MOUNT_MM - distance;
+}
+
+/*
+ * On-chip temperature in degrees C
+ */
 int temperature(void){
     int raw;
-    float voltage, temperature;
+    int32_t mv;
     adc_single_init(10);
-    raw = adc_single_read();
-    voltage = raw*(2.5/1024);
-    temperature = (raw-0.986)/0.00355;
-    return int(temperature);
+    raw = ((int16_t)adc_single_read() >> 6) + 512;  // ADC10DF is 2's complement, back to straight binary
+    mv = ((int32_t)raw * 2500) / 1024;
+    return (int)(((mv - 986) * 1000) / 3550);   // 3.55 mV/C with 986 mV at 0 C
 }
 
-int moisture(){
-
+/*
+ * Interrupts
+ */
+// CCR0 interrupt vector, echo timeout
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector=TIMER1_A0_VECTOR
+__interrupt void TIMER1_A0_ISR(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER1_A0_VECTOR))) TIMER1_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    if(echo_state != ECHO_DONE){
+        echo_state = ECHO_TIMED_OUT;
+    }
+    TA1CCTL0 &= ~CCIE;
+    TA1CCTL1 &= ~CCIE;
+    LPM0_EXIT;                              // Exit LPM0
+}
 
+// CCR1 interrupt vector, echo edges
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector=TIMER1_A1_VECTOR
+__interrupt void TIMER1_A1_ISR(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER1_A1_VECTOR))) TIMER1_A1_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    switch(TA1IV){
+    case TA1IV_TACCR1:
+        if(echo_state == ECHO_WAIT_RISE){
+            echo_rise = TA1CCR1;
+            echo_state = ECHO_WAIT_FALL;
+        }
+        else if(echo_state == ECHO_WAIT_FALL){
+            echo_fall = TA1CCR1;
+            echo_state = ECHO_DONE;
+            TA1CCTL0 &= ~CCIE;
+            TA1CCTL1 &= ~CCIE;
+            LPM0_EXIT;                      // Exit LPM0
+        }
+        break;
+    }
 }
@@ -8,8 +8,21 @@
 #ifndef SENSORS_H_
 #define SENSORS_H_
 
+// Ultrasonic ranger for snow depth, trigger on P2.0 and echo on P2.1 (TA1.1 capture input)
+#define DEPTH_MOUNT_MM      3000        // Height of the ranger above bare ground
+#define DEPTH_PINGS         5           // Pings per reading, the median is reported
+#define DEPTH_GAP_TICKS     (PWR_ACLK_HZ/100)   // 10 ms between pings for the last echoes to die out
+#define ECHO_TICK_HZ        (PWR_DCO_MHZ * 1000000UL / 8)   // Timer1_A runs off of SMCLK/8
+#define ECHO_TIMEOUT        (ECHO_TICK_HZ * 3 / 100)        // 30 ms, an echo from ~5 m
+#define TRIGGER_CYCLES      (PWR_DCO_MHZ * 10)              // 10 us trigger pulse
+
+#if ECHO_TIMEOUT > 0xFFFF
+#error ECHO_TIMEOUT must fit in TA1CCR0, use a larger divider at this DCO frequency
+#endif
 
 int temperature(void);
+int snow_depth_init(void);
+int snow_depth(void);
 
 
 
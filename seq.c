@@ -0,0 +1,47 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Report sequence numbers and the recent reports kept to resend, see seq.h
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+#include "packet.h"
+#include "seq.h"
+
+uint8_t seq_next = 0;
+uint8_t seq_kept = 0;                       // Slots of seq_recent in use, only short of full after a reset
+PKT_Frame seq_recent[PKT_RECENT];           // Report n is in slot n % PKT_RECENT, so PKT_RECENT divides 256
+
+/*
+ * Numbers a finished report and keeps a copy of it. The report must not change after this.
+ */
+void seq_stamp(PKT_Frame *pkt){
+    uint8_t slot = seq_next % PKT_RECENT;
+    if(seq_next == 0 && seq_kept == 0){
+        pkt->buf[1] |= PKT_F_BOOT;
+    }
+    pkt_set_seq(pkt, seq_next);
+    seq_recent[slot] = *pkt;
+    if(seq_kept < PKT_RECENT){
+        seq_kept++;
+    }
+    seq_next++;
+}
+
+/*
+ * Returns the kept copy of report seq, or 0 if it has been overwritten or was never sent
+ */
+PKT_Frame *seq_find(uint8_t seq){
+    uint8_t back = seq_next - 1 - seq;      // How many reports ago, wraps with the sequence
+    if(back >= seq_kept){
+        return 0;
+    }
+    return &seq_recent[seq % PKT_RECENT];
+}
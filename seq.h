@@ -0,0 +1,27 @@
+/*
+ * Author: Evan Jones III
+ * Initial Commit: 10/19/2026
+ * Last Commit: 10/19/2026
+ *
+ * Report sequence numbers and the node's side of selective repeat. Every report gets the next 8 bit
+ * sequence number and a copy is kept in a ring of the last PKT_RECENT, so when the base station
+ * finds a gap and asks with PKT_CMD_RESEND the node can send the missing ones again. The first
+ * report after a reset is flagged PKT_F_BOOT so the base station knows the numbering started over.
+ * The ring takes PKT_RECENT frames of RAM, 136 bytes with the default of 4.
+ *
+ * This work is covered under the MIT License
+ * For license information, refer to the license file
+ *
+ * Written using Code Composer Studio v12. Have fun porting elsewhere :D
+ */
+
+#include <stdint.h>
+#include "packet.h"
+
+#ifndef SEQ_H_
+#define SEQ_H_
+
+void seq_stamp(PKT_Frame *pkt);
+PKT_Frame *seq_find(uint8_t seq);
+
+#endif /* SEQ_H_ */
@@ -1,7 +1,7 @@
 /*
  * Author: Evan Jones III
  * Initial Commit: 11/25/2025
- * Last Commit: 11/26/2025
+ * Last Commit: 10/19/2026
  *
  * A library for controlling the USCI (serial comm) interfaces. This is a combination of
  * the older i2c.h and spi.h libraries, which were removed for incompatability reasons when doing
@@ -18,6 +18,7 @@
 #include <msp430g2553.h>
 #include <stdint.h>
 #include "usci.h"
+#include "power.h"
 
 // Typedef for a USCI State machine
 typedef enum USCI_ModeEnum{
@@ -38,9 +39,9 @@ USCI_Mode uscib0 = IDLE;
  */
 // Global Variables
 uint8_t A0_TX_BUF[MAX_BUF_SIZE] = {0};
-uint8_t A0_RX_BUF[MAX_BUF_SIZE] = {0};
+uint8_t A0_RX_BUF[MAX_BUF_SIZE+1] = {0};    // [length] gets the byte clocked in with reg
 uint8_t B0_TX_BUF[MAX_BUF_SIZE] = {0};
-uint8_t B0_RX_BUF[MAX_BUF_SIZE] = {0};
+uint8_t B0_RX_BUF[MAX_BUF_SIZE+1] = {0};
 uint8_t A0TxByteCtr = 0;
 uint8_t A0RxByteCtr = 0;
 uint8_t B0TxByteCtr = 0;
@@ -77,15 +78,18 @@ int A0_spi_transmit(char reg, char *data, char length){
         return -1;                          // Error if trying to send array larger than max buffer size
     }
     else{
-        char i;
+        uint8_t i;
         for(i=0; i<length; i++){            // Create a sort of FIFO buffer where the first byte out is the highest index in the array
             A0_TX_BUF[i] = *(data+(length-1)-i);
         }
         A0TxByteCtr = length - 1;           // Set counter for bytes remaining to be transmitted
         UCA0TXBUF = reg;                    // Transmit register
+        __disable_interrupt();              // Nothing can wake the CPU before it sleeps
         IE2 |= UCA0TXIE;                    // Enable tx interrupt
         uscia0 = SPI_TX;                    // Set state machine to SPI_TX mode
-        LPM0;                               // Enter low power mode
+        power_lpm_enter(PWR_LPM0);
+        __bis_SR_register(LPM0_bits + GIE); // Sleep with interrupts on, the ISR can't run before LPM0
+        power_lpm_exit();
     }
     return 0;
 }
@@ -102,12 +106,16 @@ int A0_spi_receive(char reg, char *data, char length){
         return -1;                          // Error if trying to send array larger than max buffer size
     }
     else{
-        A0RxByteCtr = length-1;             // Set counter for expected bytes to be received
-        UCA0TXBUF = reg;                    // Transmit register byte
-        IE2 |= UCA0RXIE;                    // Enable rx interrupt
+        A0RxByteCtr = length;               // Set counter for expected bytes, plus the one clocked in with reg
         uscia0 = SPI_RX;                    // Set state machine to SPI_RX mode
-        LPM0;                               // Enter low power mode until reception is complete
-        char i;
+        IFG2 &= ~UCA0RXIFG;                 // Drop the last byte clocked in by a transmit
+        __disable_interrupt();              // Nothing can wake the CPU before it sleeps
+        IE2 |= UCA0RXIE;                    // Enable rx interrupt
+        UCA0TXBUF = reg;                    // Transmit register byte
+        power_lpm_enter(PWR_LPM0);
+        __bis_SR_register(LPM0_bits + GIE); // Sleep until reception is complete, the ISR can't run before LPM0
+        power_lpm_exit();
+        uint8_t i;
         for(i=0;i<length;i++){              // RX buf will be backwards from expected, so data is transferred in reverse indexing
             *(data+(length-1)-i) = A0_RX_BUF[i];
         }
@@ -149,15 +157,18 @@ int B0_spi_transmit(char reg, char *data, char length){
     }
     else{
         uscib0 = SPI_TX;                    // Set state machine to SPI_TX mode
-        char i;
+        uint8_t i;
         for(i=0; i<length; i++){            // Create a sort of FIFO buffer where the first byte out is the highest index in the array
             B0_TX_BUF[i] = *(data+(length-1)-i);
         }
         B0TxByteCtr = length - 1;           // Set counter for bytes remaining to be transmitted
         while (!(IFG2 & UCB0TXIFG));        // Wait until TX buffer ready
         UCB0TXBUF = reg;                    // Transmit register
+        __disable_interrupt();              // Nothing can wake the CPU before it sleeps
         IE2 |= UCB0TXIE;                    // Enable tx interrupt
-        LPM0;                               // Enter low power mode
+        power_lpm_enter(PWR_LPM0);
+        __bis_SR_register(LPM0_bits + GIE); // Sleep with interrupts on, the ISR can't run before LPM0
+        power_lpm_exit();
     }
     return 0;
 }
@@ -175,14 +186,17 @@ int B0_spi_receive(char reg, char *data, char length){
     }
     else{
         uscib0 = SPI_RX;                    // Set state machine to SPI_RX mode
-        B0RxByteCtr = length-1;             // Set counter for expected bytes to be received
+        B0RxByteCtr = length;               // Set counter for expected bytes, plus the one clocked in with reg
         while(!(IFG2 & UCB0TXIFG));         // Wait until TX buffer ready
-        __enable_interrupt();               // Enable global interrupts
+        IFG2 &= ~UCB0RXIFG;                 // Drop the last byte clocked in by a transmit
+        __disable_interrupt();              // Nothing can wake the CPU before it sleeps
         IE2 |= UCB0RXIE;                    // Enable rx interrupt
         UCB0TXBUF = reg;                    // Transmit register byte
-        LPM0;                               // Enter low power mode until reception is complete
+        power_lpm_enter(PWR_LPM0);
+        __bis_SR_register(LPM0_bits + GIE); // Sleep until reception is complete, the ISR can't run before LPM0
+        power_lpm_exit();
         //while(!(B0RxByteCtr==0));           // Wait until bytes are received
-        char i;
+        uint8_t i;
         for(i=0;i<length;i++){              // RX buf will be backwards from expected, so data is transferred in reverse indexing
             *(data+(length-1)-i) = B0_RX_BUF[i];
         }
@@ -200,7 +214,7 @@ int B0_spi_receive(char reg, char *data, char length){
  * rx_length is the number of bytes to be received. If only expecting a char and not a char array, set length = 1
  */
 int B0_spi_trx(char reg, char *tx_data, char tx_length, char *rx_data, char rx_length){
-
+    (void)reg; (void)tx_data; (void)tx_length; (void)rx_data; (void)rx_length;  // TODO
     return 0;
 }
 
@@ -246,6 +260,9 @@ void __attribute__ ((interrupt(USCIAB0TX_VECTOR))) USCIAB0TX_ISR (void)
         case UART_TX:                       // TODO UART
 
             break;
+
+        default:
+            break;
         }
 
     }
@@ -270,6 +287,9 @@ void __attribute__ ((interrupt(USCIAB0TX_VECTOR))) USCIAB0TX_ISR (void)
         case I2C_TX:                        // TODO I2C
 
             break;
+
+        default:
+            break;
         }
     }
 
@@ -301,6 +321,7 @@ void __attribute__ ((interrupt(USCIAB0RX_VECTOR))) USCIAB0RX_ISR (void)
                 A0_RX_BUF[A0RxByteCtr] = UCA0RXBUF;      // Add byte to TX buffer and increment counter
                 A0RxByteCtr--;
                 IFG2 &= ~UCA0RXIFG;         // Resets TX flag
+                UCA0TXBUF = 0xFF;           // Dummy byte clocks in the next one
             }
 
             break;
@@ -308,6 +329,9 @@ void __attribute__ ((interrupt(USCIAB0RX_VECTOR))) USCIAB0RX_ISR (void)
         case UART_RX:                       // TODO UART
 
             break;
+
+        default:
+            break;
         }
 
     }
@@ -326,6 +350,7 @@ void __attribute__ ((interrupt(USCIAB0RX_VECTOR))) USCIAB0RX_ISR (void)
                 B0_RX_BUF[B0RxByteCtr] = UCB0RXBUF;      // Add byte to TX buffer and increment counter
                 B0RxByteCtr--;
                 IFG2 &= ~UCB0RXIFG;         // Resets TX flag
+                UCB0TXBUF = 0xFF;           // Dummy byte clocks in the next one
             }
             break;
 
@@ -333,6 +358,8 @@ void __attribute__ ((interrupt(USCIAB0RX_VECTOR))) USCIAB0RX_ISR (void)
 
             break;
 
+        default:
+            break;
         }
     }
 }